@@ -8,6 +8,11 @@
 #include <stdexcept>
 
 #include "tfl/Automata.hpp"
+#include "tfl/AutomataOps.hpp"
+#include "tfl/Unicode.hpp"
+
+#include <deque>
+#include <string>
 
 using DFA = tfl::DFA<char>;
 static constexpr auto DEAD_STATE = DFA::DEAD_STATE;
@@ -83,6 +88,107 @@ TEST_CASE("DEAD state allows early termination", "[DFA]") {
 }
 
 
+TEST_CASE("Self-looping states are skipped", "[DFA]") {
+    using Regex = tfl::Regex<char>;
+
+    auto quote = Regex::literal('"');
+    auto backslash = Regex::literal('\\');
+    DFA string = tfl::make_dfa(quote - *((Regex::alphabet() / (backslash | quote)) | (backslash - Regex::alphabet())) - quote);
+    DFA comment = tfl::make_dfa(Regex::literal('#') - *(Regex::alphabet() / Regex::literal('\n')));
+
+    std::string literal = '"' + std::string(100000, 'x') + "\\\"" + std::string(100000, 'y') + '"';
+    std::string line = '#' + std::string(200000, 'z') + '\n';
+    std::deque<char> literal_deque(literal.begin(), literal.end());
+    std::deque<char> line_deque(line.begin(), line.end());
+
+    REQUIRE( string.munch(literal) == literal.size() );
+    REQUIRE( string.munch(literal_deque) == literal.size() );
+    REQUIRE( comment.munch(line) == line.size() - 1 );
+    REQUIRE( comment.munch(line_deque) == line.size() - 1 );
+
+    BENCHMARK("String literal, byte per byte") {
+        return string.munch(literal_deque);
+    };
+
+    BENCHMARK("String literal, skipped") {
+        return string.munch(literal);
+    };
+
+    BENCHMARK("Comment, byte per byte") {
+        return comment.munch(line_deque);
+    };
+
+    BENCHMARK("Comment, skipped") {
+        return comment.munch(line);
+    };
+}
+
+TEST_CASE("Backward matching", "[DFA]") {
+    using Regex = tfl::Regex<char>;
+    using Regexes = tfl::Regexes<char>;
+
+    Regex trailer = Regexes::word(std::string("END")) - +Regexes::range('0', '9') - Regex::literal(';');
+    DFA forward = tfl::make_dfa(Regex::any() - trailer);
+    DFA backward = tfl::make_reverse_dfa(trailer);
+
+    std::string record = std::string(1000000, 'x') + "END42;";
+    REQUIRE( forward.accepts(record) );
+    REQUIRE( backward.munch_backward(record) == 6 );
+
+    BENCHMARK("Forward validation") {
+        return forward.accepts(record);
+    };
+
+    BENCHMARK("Backward validation") {
+        return backward.munch_backward(record);
+    };
+}
+
+TEST_CASE("UTF-8 matching", "[DFA]") {
+    using Regex = tfl::Regex<char32_t>;
+    using Regexes = tfl::Regexes<char32_t>;
+
+    Regex letter = Regexes::range('a', 'z') | Regexes::range(0xE0, 0xFF) | Regexes::range(0x3B1, 0x3C9);
+    DFA bytes = tfl::make_utf8_dfa(*(letter | Regex::literal(' ')));
+    tfl::DFA<char32_t> code_points = tfl::make_dfa(*(letter | Regex::literal(' ')));
+
+    std::u32string text;
+    for(int i = 0; i < 50000; ++i) {
+        text += U"àλb ";
+    }
+    std::string encoded;
+    for(char32_t c: text) {
+        if(c < 0x80) {
+            encoded += static_cast<char>(c);
+        }
+        else {
+            encoded += static_cast<char>(0xC0 | (c >> 6));
+            encoded += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+
+    REQUIRE( bytes.accepts(encoded) );
+    REQUIRE( code_points.accepts(text) );
+
+    BENCHMARK("Decode, then match the code points") {
+        std::u32string decoded;
+        for(std::size_t i = 0; i < encoded.size(); ++i) {
+            unsigned char byte = encoded[i];
+            if(byte < 0x80) {
+                decoded += byte;
+            }
+            else {
+                decoded += ((byte & 0x1F) << 6) | (static_cast<unsigned char>(encoded[++i]) & 0x3F);
+            }
+        }
+        return code_points.accepts(decoded);
+    };
+
+    BENCHMARK("Match the UTF-8 bytes") {
+        return bytes.accepts(encoded);
+    };
+}
+
 /*
 Specs:
     OS: Debian GNU/Linux 10 (buster) x86_64 
@@ -0,0 +1,162 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "tfl/Lexer.hpp"
+
+using Regexes = tfl::Regexes<char>;
+
+namespace {
+    // Number of allocations made by the benchmarks so far.
+    std::atomic<std::size_t> allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    if(void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC cannot tell that the replaced operator new uses malloc.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+#pragma GCC diagnostic pop
+
+TEST_CASE("Incremental relexing", "[lexer]") {
+    auto alpha = Regexes::range('a', 'z');
+    auto digit = Regexes::range('0', '9');
+    auto lexer = tfl::Lexer<char, int>::make_dfa_lexer({
+        {+alpha, [](auto){ return 0; }},
+        {+digit, [](auto){ return 1; }},
+        {+Regexes::literal(' '), [](auto){ return 2; }},
+        {Regexes::literal('\n'), [](auto){ return 3; }},
+    });
+
+    std::string input;
+    for(std::size_t i = 0; input.size() < 20000; ++i) {
+        input += "word " + std::to_string(i) + " another word\n";
+    }
+    auto tokens = lexer(input);
+
+    BENCHMARK("Lex from scratch after an edit") {
+        input[input.size() / 2] = (input[input.size() / 2] == ' ') ? ' ' : 'x';
+        return lexer(input);
+    };
+
+    BENCHMARK("Relex after an edit") {
+        input[input.size() / 2] = (input[input.size() / 2] == ' ') ? ' ' : 'x';
+        return lexer.relex(tokens, tfl::Edit{input.size() / 2, 1, 1}, input);
+    };
+
+    // Inserting a line shifts the following tokens and lines.
+    BENCHMARK("Relex after an insertion") {
+        std::size_t position = input.size() / 2;
+        input.insert(position, "x\n");
+        return lexer.relex(tokens, tfl::Edit{position, 0, 2}, input);
+    };
+
+    REQUIRE( tokens == lexer(input) );
+}
+
+TEST_CASE("Line tracking", "[lexer]") {
+    auto alpha = Regexes::range('a', 'z');
+    auto nl = Regexes::literal('\n');
+    auto lexer = tfl::Lexer<char, int>::make_dfa_lexer({
+        {+alpha, [](auto){ return 0; }},
+        {+(Regexes::literal(' ') | nl), [](auto){ return 1; }},
+    }, nl);
+
+    std::string input;
+    while(input.size() < 20000) {
+        input += "some words\n\n  on several\n lines ";
+    }
+
+    BENCHMARK("Lex a contiguous input (indexed in one pass)") {
+        return lexer(input);
+    };
+
+    BENCHMARK("Lex a buffered input (scanned token by token)") {
+        return lexer(tfl::InputBuffer<char>(input | std::views::all));
+    };
+}
+
+TEST_CASE("Error recovery", "[lexer]") {
+    auto alpha = Regexes::range('a', 'z');
+    auto lexer = tfl::Lexer<char, int>::make_dfa_lexer({
+        {+alpha, [](auto){ return 0; }},
+        {+Regexes::literal(' '), [](auto){ return 1; }},
+    }).recovering([](auto){ return -1; });
+
+    // Corrupt runs of increasing length.
+    std::string input;
+    for(std::size_t i = 0; input.size() < 20000; ++i) {
+        input += "some valid words " + std::string(i % 16, '#');
+    }
+
+    BENCHMARK("Lex an input with unlexable runs") {
+        return lexer(input);
+    };
+}
+
+TEST_CASE("Lexing allocations", "[lexer]") {
+    auto alpha = Regexes::range('a', 'z');
+    auto digit = Regexes::range('0', '9');
+    auto lexer = tfl::Lexer<char, int>::make_dfa_lexer({
+        {+alpha, [](auto){ return 0; }},
+        {+digit, [](auto){ return 1; }},
+        {+Regexes::literal(' '), [](auto){ return 2; }},
+        {Regexes::literal('\n'), [](auto){ return 3; }},
+    }, Regexes::literal('\n'));
+
+    std::string input;
+    for(std::size_t i = 0; input.size() < 100000; ++i) {
+        input += "word " + std::to_string(i) + " another word\n";
+    }
+
+    // The matchers are not copied: the allocations come from the growth of the buffers, not from the tokens.
+    std::size_t before = allocations;
+    auto tokens = lexer(input);
+    std::size_t allocated = allocations - before;
+    INFO( std::to_string(allocated) + " allocations for " + std::to_string(tokens.size()) + " tokens" );
+    CHECK( allocated < tokens.size() / 10 );
+
+    BENCHMARK("Lex 100 kB") {
+        return lexer(input);
+    };
+}
+
+TEST_CASE("Derivation lexer scaling", "[lexer]") {
+    auto alpha = Regexes::range('a', 'z');
+    auto digit = Regexes::range('0', '9');
+    auto lexer = tfl::Lexer<char, int>::make_derivation_lexer({
+        {+alpha, [](auto){ return 0; }},
+        {+digit & ~(Regexes::literal('0') - +digit), [](auto){ return 1; }},
+        {+Regexes::literal(' '), [](auto){ return 2; }},
+    });
+
+    // The lexing time should double with the size of the input.
+    for(std::size_t size: {2000, 4000, 8000, 16000}) {
+        std::string input;
+        for(std::size_t i = 0; input.size() < size; ++i) {
+            input += "word " + std::to_string(i) + " ";
+        }
+
+        BENCHMARK("Lex " + std::to_string(size / 1000) + " kB") {
+            return lexer(input);
+        };
+    }
+}
@@ -39,7 +39,9 @@ TEST_CASE("Regex `accept`s benchmarking", "[regex]") {
 
     Regex regex = r1-any-r2;
     NFA nfa = tfl::make_nfa<char>(regex);
+    NFA pd_nfa = tfl::make_nfa_by_partial_derivatives<char>(regex);
     DFA dfa = tfl::make_dfa<char>(regex);
+    std::cout << "NFA states: " << nfa.state_count() << " (Thompson), " << pd_nfa.state_count() << " (partial derivatives)." << std::endl;
 
     static constexpr int COUNT = 100;
     static constexpr int LOW = 10;
@@ -51,13 +53,16 @@ TEST_CASE("Regex `accept`s benchmarking", "[regex]") {
         bool b1(daccept(regex, input));
         bool b2(nfa.accepts(input));
         bool b3(dfa.accepts(input));
+        bool b4(pd_nfa.accepts(input));
 
         INFO("Verify that the different regex matchers yield the same results");
         INFO("Derivation: " << b1);
         INFO("NFA: " << b2);
         INFO("DFA: " << b3);
+        INFO("Partial-derivative NFA: " << b4);
         REQUIRE(b1 == b2);
         REQUIRE(b2 == b3);
+        REQUIRE(b3 == b4);
 
         if(b1) {
             ++i;
@@ -86,6 +91,16 @@ TEST_CASE("Regex `accept`s benchmarking", "[regex]") {
         meter.measure([&nfa, &data](int i) { return nfa.accepts(data[i]); });
     };
 
+    BENCHMARK("Building the partial-derivative NFA") {
+        return tfl::make_nfa_by_partial_derivatives<char>(regex);
+    };
+
+    BENCHMARK_ADVANCED("Using a partial-derivative NFA")(Catch::Benchmark::Chronometer meter) {
+        std::vector<std::vector<char>> data(meter.runs());
+        std::generate(data.begin(), data.end(), [&generator](){ auto v = generator.get(); generator.next(); return v; });
+        meter.measure([&pd_nfa, &data](int i) { return pd_nfa.accepts(data[i]); });
+    };
+
     BENCHMARK("Building the DFA") {
         return tfl::make_dfa<char>(regex);
     };
@@ -132,4 +147,73 @@ Result:
     Using a DFA                                    100             1    102.352 ms 
                                             1.02379 ms    1.02276 ms    1.02507 ms 
                                             5.81902 us    4.77966 us    7.25158 us
- */
\ No newline at end of file
+ */
+TEST_CASE("Derivation of large regexes", "[regex]") {
+    // A union of keywords, as built by a lexer with many rules.
+    Regex keywords = Regex::empty();
+    for(int i = 0; i < 200; ++i) {
+        std::string keyword = "kw" + std::to_string(i);
+        keywords = keywords | Regexes::word(std::vector<char>(keyword.begin(), keyword.end()));
+    }
+    Regex regex = *(keywords - Regex::literal(' '));
+
+    std::string input;
+    for(int i = 0; i < 20; ++i) {
+        input += "kw" + std::to_string(i * 7) + " ";
+    }
+
+    BENCHMARK("Derive a 200-keyword regex") {
+        return tfl::is_nullable(tfl::derive(input, regex));
+    };
+}
+
+TEST_CASE("Building large rule sets", "[regex]") {
+    std::vector<Regex> keywords;
+    for(int i = 0; i < 200; ++i) {
+        keywords.push_back(Regexes::word("kw" + std::to_string(i)));
+    }
+
+    BENCHMARK("Make the DFA of 200 keywords, as a right-nested union") {
+        Regex regex = Regex::empty();
+        for(auto it = keywords.rbegin(); it != keywords.rend(); ++it) {
+            regex = *it | regex;
+        }
+        return tfl::make_dfa(regex);
+    };
+
+    BENCHMARK("Make the DFA of 200 keywords, as a balanced union (any_of)") {
+        return tfl::make_dfa(Regexes::any_of(keywords));
+    };
+
+    Regex regex = Regexes::any_of(keywords);
+
+    BENCHMARK("Make the Thompson NFA of 200 keywords") {
+        return tfl::make_nfa(regex);
+    };
+
+    BENCHMARK("Make the Glushkov NFA of 200 keywords") {
+        return tfl::make_glushkov_nfa(regex);
+    };
+
+    Regex deep = Regex::literal('a');
+    for(int i = 0; i < 100000; ++i) {
+        deep = deep - Regex::literal('a' + i % 3);
+    }
+
+    BENCHMARK("Print a regex of depth 100000") {
+        return tfl::to_string(deep);
+    };
+}
+
+TEST_CASE("Bounded repetitions", "[regex]") {
+    Regex hex = Regexes::range('0', '9') | Regexes::range('a', 'f');
+    Regex quote = Regex::literal('"');
+
+    BENCHMARK("Make the DFA of a 1-to-32 hex digit string, as a repetition") {
+        return tfl::make_dfa(quote - Regexes::repeat(hex, 1, 32) - quote);
+    };
+
+    BENCHMARK("Make the DFA of a 1-to-32 hex digit string, unrolled") {
+        return tfl::make_dfa(quote - Regex::unroll(hex, 1, 32) - quote);
+    };
+}
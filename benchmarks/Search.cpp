@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tfl/Search.hpp"
+
+using Regex = tfl::Regex<char>;
+using Regexes = tfl::Regexes<char>;
+
+TEST_CASE("Literal prefilter", "[search]") {
+    Regex digit = Regexes::range('0', '9');
+    Regex space = Regex::literal(' ');
+    Regex regex = (Regexes::word(std::string("ERROR")) | Regexes::word(std::string("FATAL"))) - space - +digit;
+
+    std::string log;
+    for(std::size_t i = 0; i < 20000; ++i) {
+        log += "2023-01-01 12:00:00 INFO request handled in " + std::to_string(i % 97) + " ms\n";
+        if(i % 1000 == 0) {
+            log += "2023-01-01 12:00:00 ERROR " + std::to_string(i) + " failed\n";
+        }
+    }
+
+    tfl::DFA<char> dfa = tfl::make_dfa(regex);
+    tfl::Searcher<char> searcher(regex);
+    REQUIRE( searcher.has_prefilter() );
+    REQUIRE( searcher.find_all(log).size() == 20 );
+    REQUIRE( searcher.find_all(log) == dfa.find_all(log) );
+
+    BENCHMARK("Munch at every position") {
+        std::vector<tfl::Match> matches;
+        for(std::size_t position = 0; position < log.size(); ++position) {
+            auto length = dfa.munch(std::string_view(log).substr(position));
+            if(length.has_value()) {
+                matches.push_back({position, *length});
+                position += *length - 1;
+            }
+        }
+        return matches;
+    };
+
+    BENCHMARK("Aho-Corasick prefilter") {
+        return searcher.find_all(log);
+    };
+}
+
+TEST_CASE("Unanchored search", "[search]") {
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+    tfl::DFA<char> dfa = tfl::make_dfa(+a - b);
+
+    std::string input(5000, 'a');
+    input[input.size() / 2] = 'b';
+    REQUIRE( dfa.find_all(input) == std::vector<tfl::Match>{{0, input.size() / 2 + 1}} );
+
+    BENCHMARK("Munch at every position") {
+        std::vector<tfl::Match> matches;
+        for(std::size_t position = 0; position < input.size(); ++position) {
+            auto length = dfa.munch(std::string_view(input).substr(position));
+            if(length.has_value()) {
+                matches.push_back({position, *length});
+                position += *length - 1;
+            }
+        }
+        return matches;
+    };
+
+    BENCHMARK("Forward and backward passes") {
+        return dfa.find_all(input);
+    };
+}
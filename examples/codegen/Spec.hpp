@@ -0,0 +1,21 @@
+#pragma once
+
+#include <tfl/Regex.hpp>
+
+/**
+ * The tokens recognized by the generated scanner, shared by the generator and the program using it.
+ */
+static class: tfl::Regexes<char> {
+    using Regex = tfl::Regex<char>;
+
+public:
+    Regex const digit       = range('0', '9');
+    Regex const alpha       = range('a', 'z') | range('A', 'Z') | literal('_');
+
+    // Lines are not tracked by this example.
+    Regex const newline     = empty();
+    Regex const space       = +any_of({' ', '\t', '\n', '\r'});
+    Regex const identifier  = alpha - *(alpha | digit);
+    Regex const number      = +digit - opt(literal('.') - +digit);
+    Regex const op          = any_of({'+', '-', '*', '/', '=', '(', ')', ';'});
+} spec;
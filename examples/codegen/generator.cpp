@@ -0,0 +1,25 @@
+#include <iostream>
+#include <fstream>
+
+#include <tfl/AutomataOps.hpp>
+#include <tfl/Codegen.hpp>
+
+#include "Spec.hpp"
+
+int main(int argc, char** argv) {
+    if(argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <output header>" << std::endl;
+        return 1;
+    }
+
+    std::ofstream output(argv[1]);
+    output << tfl::cpp_source<char>("scanner", {
+        {"newline",     tfl::make_dfa(spec.newline)},
+        {"space",       tfl::make_dfa(spec.space)},
+        {"identifier",  tfl::make_dfa(spec.identifier)},
+        {"number",      tfl::make_dfa(spec.number)},
+        {"op",          tfl::make_dfa(spec.op)},
+    });
+
+    return output ? 0 : 1;
+}
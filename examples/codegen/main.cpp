@@ -0,0 +1,38 @@
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include <tfl/Lexer.hpp>
+
+// Generated from Spec.hpp by the "CodegenGenerator" target.
+#include "Scanner.hpp"
+
+enum class Kind { SPACE, IDENTIFIER, NUMBER, OPERATOR };
+
+struct Token {
+    Kind kind;
+    std::string text;
+};
+
+int main() {
+    using Rule = tfl::Rule<char, scanner::Automaton, Token>;
+    auto token = [](Kind kind){ 
+        return [kind](auto w){ return Token{kind, std::string(w.begin(), w.end())}; };
+    };
+
+    auto lexer = tfl::Lexer<char, Token>::make_dfa_lexer({
+        Rule{scanner::space,        token(Kind::SPACE)},
+        Rule{scanner::identifier,   token(Kind::IDENTIFIER)},
+        Rule{scanner::number,       token(Kind::NUMBER)},
+        Rule{scanner::op,           token(Kind::OPERATOR)},
+    }, scanner::newline);
+
+    std::string input(std::istreambuf_iterator<char>(std::cin), {});
+    for(auto const& token: lexer(input)) {
+        if(token.value().kind != Kind::SPACE) {
+            std::cout << token.column() << '\t' << token.value().text << '\n';
+        }
+    }
+
+    return 0;
+}
@@ -18,7 +18,7 @@ static class: tfl::Regexes<char> {
     Regex const str_char = alphabet() / (literal('\\') | quote | range('\0', ' '-1));
     Regex const ctr_char = any_of("\"\\/bfnrt"_v);
     Regex const hex_digit = range('0', '9') | range('a', 'f') | range('A', 'F');
-    Regex const unicode = literal('u') - hex_digit - hex_digit - hex_digit - hex_digit;
+    Regex const unicode = literal('u') - repeat(hex_digit, 4);
     Regex const control = literal('\\') - (ctr_char | unicode);
     Regex const string = quote - *(str_char | control) - quote;
 
@@ -9,8 +9,14 @@
 #include <set>
 #include <queue>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <iterator>
+#include <map>
+#include <type_traits>
 
 #include "tfl/Stringify.hpp"
+#include "tfl/Simd.hpp"
 
 /**
  * @brief Contains the definition of DFAs and NFAs.
@@ -22,6 +28,142 @@ namespace tfl {
     template<typename T>
     class NFA;
 
+    /**
+     * @brief Specifies that the symbols of a type can be grouped into intervals of consecutive values.
+     *
+     * The automata over such types store their transitions per interval (see \ref DFA), 
+     * the others (including the bytes, whose alphabets are small) per symbol.
+     */
+    template<typename T>
+    concept interval_partitionable = std::integral<T> && !byte_like<T>;
+
+    /**
+     * @brief The transitions of an automaton on \f$ T^{-} \f$: one column (indexed by state) per class of symbols.
+     *
+     * For \ref interval_partitionable types, the classes are the coarsest partition of \f$ T^{-} \f$ into intervals
+     * of consecutive symbols sharing their column, found by binary search. Otherwise, each symbol is its own class.
+     *
+     * @tparam T Type of the alphabet.
+     * @tparam Column Type of the transitions of a symbol from every state.
+     */
+    template<typename T, typename Column>
+    class SymbolClasses final {
+        struct Interval {
+            T low;
+            T high;
+        };
+
+        std::unordered_map<T, Column> _symbols;
+        std::vector<Interval> _intervals;
+        std::vector<Column> _columns;
+
+        static std::size_t width(Interval const& interval) {
+            using U = std::make_unsigned_t<T>;
+            return static_cast<std::size_t>(static_cast<U>(interval.high) - static_cast<U>(interval.low)) + 1;
+        }
+
+    public:
+        SymbolClasses() = default;
+
+        /**
+         * @brief Builds the classes from a range of (symbol, column) pairs.
+         */
+        template<std::ranges::input_range R>
+        SymbolClasses(R&& transitions) {
+            if constexpr(interval_partitionable<T>) {
+                std::vector<std::pair<T, Column>> sorted(std::ranges::begin(transitions), std::ranges::end(transitions));
+                std::ranges::sort(sorted, {}, [](auto const& p){ return p.first; });
+                for(auto& [x, column]: sorted) {
+                    if(!_intervals.empty() && static_cast<T>(_intervals.back().high + 1) == x && _columns.back() == column) {
+                        _intervals.back().high = x;
+                    }
+                    else {
+                        _intervals.push_back({x, x});
+                        _columns.push_back(std::move(column));
+                    }
+                }
+            }
+            else {
+                _symbols.insert(std::ranges::begin(transitions), std::ranges::end(transitions));
+            }
+        }
+
+        /**
+         * @brief Returns the column of the class of `x`, or `nullptr` if \f$ x \not\in T^{-} \f$.
+         */
+        Column const* find(T const& x) const {
+            if constexpr(interval_partitionable<T>) {
+                auto it = std::ranges::upper_bound(_intervals, x, {}, &Interval::low);
+                if(it == _intervals.cbegin() || std::prev(it)->high < x) {
+                    return nullptr;
+                }
+                return &_columns[std::prev(it) - _intervals.cbegin()];
+            }
+            else {
+                auto it = _symbols.find(x);
+                return (it != _symbols.cend()) ? &it->second : nullptr;
+            }
+        }
+
+        /**
+         * @brief Returns the number of classes.
+         */
+        std::size_t class_count() const {
+            if constexpr(interval_partitionable<T>) {
+                return _intervals.size();
+            }
+            else {
+                return _symbols.size();
+            }
+        }
+
+        /**
+         * @brief Calls `f(x, column)` for each \f$ x \in T^{-} \f$.
+         */
+        template<typename F>
+        void for_each(F&& f) const {
+            if constexpr(interval_partitionable<T>) {
+                for(std::size_t i = 0; i < _intervals.size(); ++i) {
+                    for(std::size_t k = 0; k < width(_intervals[i]); ++k) {
+                        f(static_cast<T>(_intervals[i].low + k), _columns[i]);
+                    }
+                }
+            }
+            else {
+                for(auto const& [x, column]: _symbols) {
+                    f(x, column);
+                }
+            }
+        }
+
+        /**
+         * @brief Returns \f$ T^{-} \f$, enumerated lazily from the classes.
+         */
+        auto symbols() const {
+            if constexpr(interval_partitionable<T>) {
+                return std::views::join(std::views::transform(_intervals, [](Interval const& interval){
+                    return std::views::transform(
+                        std::views::iota(std::size_t{0}, width(interval)), 
+                        [low = interval.low](std::size_t k){ return static_cast<T>(low + k); }
+                    );
+                }));
+            }
+            else {
+                return std::ranges::transform_view(_symbols, [](auto const& p){ return p.first; });
+            }
+        }
+    };
+
+    /**
+     * @brief A match found within a sequence: the subsequence starting at `position`, of `length` elements.
+     */
+    struct Match final {
+        std::size_t position;
+        std::size_t length;
+
+        bool operator==(Match const&) const = default;
+    };
+
     /**
      * @brief <a href=https://en.wikipedia.org/wiki/Deterministic_finite_automaton>Deterministic Finite Automaton</a>.
      * 
@@ -45,6 +187,10 @@ namespace tfl {
      * - The unknown transition and \f$ T^{-} \f$: allows to define the automaton on all values of type `T` without specifying every value;
      * - Default initial state: the initial state is always the state 0. Sorry but this was convenient.
      *
+     * The transitions are stored per class of \f$ T^{-} \f$ (see \ref class_count()): for \ref interval_partitionable types,
+     * the symbols sharing their transitions are grouped into intervals, found by binary search,
+     * so that the size of the DFA only depends on the number of intervals.
+     *
      * The DFA defines a language 
      * \f$ \mathcal{L} = \left\{ w \in \Sigma^* \mid \Delta(0 \times w) \in F \right\} \f$
      * where \f$ \Delta: Q \times \Sigma^* \longmapsto Q \f$ is the extended transition function
@@ -70,10 +216,17 @@ namespace tfl {
         static constexpr StateIdx const DEAD_STATE = std::numeric_limits<StateIdx>::max();
 
     private:
-        std::unordered_map<T, std::vector<StateIdx>> _transitions;
+        SymbolClasses<T, std::vector<StateIdx>> _transitions;
         std::vector<StateIdx> _unknown_transitions;
         std::vector<bool> _accepting_states;
 
+        // For byte-sized alphabets: for each state which loops on all but a few bytes, 
+        // the bytes leaving it (so that the looping bytes can be skipped, see munch_contiguous()).
+        std::vector<std::optional<ByteSet>> _skips;
+
+        // Automata used by find() and find_all(), built on first use and shared by the copies of this DFA.
+        struct Search;
+        std::shared_ptr<Search> _search = std::make_shared<Search>();
 
         static bool is_special_state(StateIdx const& state) {
             return state >= DEAD_STATE;
@@ -98,9 +251,8 @@ namespace tfl {
                 return DEAD_STATE;
             }
 
-            auto it =  _transitions.find(x);
-            if(it != _transitions.cend()) {
-                return it->second[state];
+            if(auto column = _transitions.find(x)) {
+                return (*column)[state];
             }
             else {
                 return _unknown_transitions[state];
@@ -109,7 +261,7 @@ namespace tfl {
 
         template<std::ranges::input_range Tr, std::ranges::input_range Ut, std::ranges::input_range As>
         DFA(Tr&& transitions, Ut&& unknown_transitions, As&& accepting_states): 
-        _transitions(std::ranges::cbegin(transitions), std::ranges::cend(transitions)), 
+        _transitions(std::forward<Tr>(transitions)), 
         _unknown_transitions(std::ranges::cbegin(unknown_transitions), std::ranges::cend(unknown_transitions)), 
         _accepting_states(std::ranges::cbegin(accepting_states), std::ranges::cend(accepting_states)) {
             
@@ -121,9 +273,170 @@ namespace tfl {
             };
 
             check(_accepting_states, "accepting states");
-            for(auto p: _transitions) {
-                check(p.second, Stringify<T>::convert(p.first));
+            _transitions.for_each([&check](T const& x, auto const& column){
+                check(column, Stringify<T>::convert(x));
+            });
+
+            if constexpr(byte_like<T>) {
+                _skips.resize(state_count());
+                for(StateIdx i = 0; i < state_count(); ++i) {
+                    if(_unknown_transitions[i] != i) {
+                        continue;
+                    }
+
+                    ByteSet exits;
+                    bool small = true;
+                    _transitions.for_each([&exits, &small, i](T const& x, auto const& column){ 
+                        small = small && (column[i] == i || exits.insert(static_cast<unsigned char>(x))); 
+                    });
+                    if(small) {
+                        _skips[i] = exits;
+                    }
+                }
+            }
+        }
+
+        // The DFAs for Σ*·L and Σ*·rev(L).
+        std::pair<DFA const&, DFA const&> search_automata() const {
+            std::call_once(_search->built, [this]{
+                typename NFA<T>::Builder ends(alphabet(), state_count());
+                typename NFA<T>::Builder starts(alphabet(), state_count() + 1);
+
+                for(StateIdx i = 0; i < state_count(); ++i) {
+                    _transitions.for_each([&](T const& input, auto const& transitions){
+                        if(transitions[i] != DEAD_STATE) {
+                            ends.add_transition(i, input, transitions[i]);
+                            starts.add_transition(transitions[i] + 1, input, i + 1);
+                        }
+                    });
+                    if(_unknown_transitions[i] != DEAD_STATE) {
+                        ends.add_unknown_transition(i, _unknown_transitions[i]);
+                        starts.add_unknown_transition(_unknown_transitions[i] + 1, i + 1);
+                    }
+                    ends.set_acceptance(i, _accepting_states[i]);
+                    if(_accepting_states[i]) {
+                        starts.add_epsilon_transition(0, i + 1);
+                    }
+                }
+                starts.set_acceptance(1, true);
+
+                // Σ* prefix: the initial state can always be reentered.
+                for(T const& input: alphabet()) {
+                    ends.add_transition(0, input, 0);
+                    starts.add_transition(0, input, 0);
+                }
+                ends.add_unknown_transition(0, 0);
+                starts.add_unknown_transition(0, 0);
+
+                _search->ends.emplace(ends.make_deterministic());
+                _search->starts.emplace(starts.make_deterministic());
+            });
+            return {*_search->ends, *_search->starts};
+        }
+
+        template<input_range_of<T> R>
+        std::vector<Match> search(R& sequence, bool first_only) const {
+            if constexpr(!std::ranges::bidirectional_range<R>) {
+                std::vector<T> buffer;
+                std::ranges::copy(sequence, std::back_inserter(buffer));
+                return search(buffer, first_only);
+            }
+            else {
+                auto [ends, starts] = search_automata();
+                auto beg = std::ranges::cbegin(sequence);
+                auto end = std::ranges::cend(sequence);
+
+                // Forward pass: end of the last match.
+                StateIdx state = 0;
+                std::optional<std::size_t> last = ends.is_accepting(state) ? std::optional<std::size_t>{0} : std::nullopt;
+                auto last_it = beg;
+                std::size_t position = 0;
+                for(auto it = beg; it != end && state != DEAD_STATE;) {
+                    state = ends.transition_unchecked(state, *it);
+                    ++it;
+                    ++position;
+                    if(ends.is_accepting(state)) {
+                        last = position;
+                        last_it = it;
+                    }
+                }
+
+                if(!last.has_value()) {
+                    return {};
+                }
+
+                // Backward pass: starts of the matches.
+                std::vector<bool> is_start(*last + 1, false);
+                state = 0;
+                position = *last;
+                is_start[position] = starts.is_accepting(state);
+                for(auto it = last_it; it != beg && state != DEAD_STATE;) {
+                    --it;
+                    --position;
+                    state = starts.transition_unchecked(state, *it);
+                    is_start[position] = starts.is_accepting(state);
+                }
+
+                std::vector<Match> matches;
+                auto it = beg;
+                position = 0;
+                while(true) {
+                    std::size_t step = 1;
+                    if(is_start[position]) {
+                        auto length = munch(std::ranges::subrange(it, last_it)).value();
+                        matches.push_back({position, length});
+                        if(first_only) {
+                            break;
+                        }
+                        step = std::max<std::size_t>(length, 1);
+                    }
+
+                    if(position + step > *last) {
+                        break;
+                    }
+                    position += step;
+                    std::ranges::advance(it, step);
+                }
+
+                return matches;
+            }
+        }
+
+        template<typename R>
+        static constexpr bool is_contiguous_input = byte_like<T> 
+            && std::ranges::contiguous_range<R> 
+            && std::same_as<std::remove_cv_t<std::ranges::range_value_t<R>>, T>;
+
+        // Equivalent to munch() on [beg, end[, where the states looping on most bytes are left using a vectorized search.
+        std::optional<std::size_t> munch_contiguous(T const* beg, T const* end, bool only_last) const noexcept {
+            StateIdx state = 0;
+            T const* cur = beg;
+            std::optional<std::size_t> res = is_accepting(state) ? 
+                std::optional<std::size_t>{0} : 
+                std::optional<std::size_t>{std::nullopt};
+
+            while(cur != end && state != DEAD_STATE) {
+                if(_skips[state].has_value()) {
+                    cur = _skips[state]->find(cur, end);
+                    if(is_accepting(state)) {
+                        res = cur - beg;
+                    }
+                    if(cur == end) {
+                        break;
+                    }
+                }
+
+                state = transition_unchecked(state, *cur);
+                ++cur;
+                if(is_accepting(state)) {
+                    res = cur - beg;
+                }
             }
+
+            if(only_last) {
+                return (cur == end && is_accepting(state)) ? res : std::nullopt;
+            }
+            return res;
         }
 
     public:
@@ -154,15 +467,23 @@ namespace tfl {
 
             check_ns_state(state);
 
-            auto it =  _transitions.find(x);
-            if(it != _transitions.cend()) {
-                return it->second[state];
+            if(auto column = _transitions.find(x)) {
+                return (*column)[state];
             }
             else {
                 throw std::invalid_argument("Invalid input: " + Stringify<T>::convert(x));
             }
         }
 
+        /**
+         * @brief Returns \f$ \delta(\textup{state} \times x) \f$, for any value \f$ x \f$.
+         *
+         * Unlike \ref transition(), the values which do not belong to \f$ T^{-} \f$ follow the unknown transition.
+         */
+        StateIdx step(StateIdx const& state, T const& x) const noexcept {
+            return transition_unchecked(state, x);
+        }
+
         /**
          * @brief Returns \f$ \delta(\textup{state} \times \textsc{UNKNOWN}) \f$.
          * @exception std::invalid_argument If \f$ x \not\in Q \f$
@@ -179,7 +500,18 @@ namespace tfl {
          * @brief Returns \f$ T^{-} \f$.
          */
         auto alphabet() const {
-            return transform_view(_transitions, [](auto p){ return p.first; });
+            return _transitions.symbols();
+        }
+
+        /**
+         * @brief Returns the number of classes of \f$ T^{-} \f$, whose symbols share all their transitions.
+         *
+         * For \ref interval_partitionable types, the classes are the largest intervals of consecutive symbols
+         * with the same transitions, so that a range of symbols only costs one transition per state.
+         * Otherwise, each symbol is its own class.
+         */
+        std::size_t class_count() const {
+            return _transitions.class_count();
         }
 
         /**
@@ -194,6 +526,11 @@ namespace tfl {
          */
         template<input_range_of<T> R>
         bool accepts(R&& sequence) const noexcept {
+            if constexpr(is_contiguous_input<R>) {
+                auto beg = std::ranges::data(sequence);
+                return munch_contiguous(beg, beg + std::ranges::size(sequence), true).has_value();
+            }
+
             StateIdx state = 0;
             for(
                 auto beg = std::ranges::cbegin(sequence), end = std::ranges::cend(sequence); 
@@ -228,6 +565,11 @@ namespace tfl {
          */
         template<input_range_of<T> R>
         std::optional<std::size_t> munch(R&& sequence) const noexcept {
+            if constexpr(is_contiguous_input<R>) {
+                auto beg = std::ranges::data(sequence);
+                return munch_contiguous(beg, beg + std::ranges::size(sequence), false);
+            }
+
             StateIdx state = 0;
             std::size_t step = 0;
             std::optional<std::size_t> res = is_accepting(state) ? 
@@ -259,6 +601,63 @@ namespace tfl {
         }
         ///@}
 
+        /**
+         * @brief Find the length of the longest suffix whose reversal belongs to \f$ \mathcal{L} \f$.
+         *
+         * Formally, given a sequence \f$ (x_1, x_2, \ldots, x_n) \f$ returns
+         * \f$ \max \left\{ l \mid (x_n, x_{n-1}, \ldots, x_{n-l+1}) \in \mathcal{L} \right\} \f$
+         *
+         * The sequence is read from its end, and reading stops as soon as the dead state is reached.
+         * Used with a reversed DFA (see \ref Builder::reverse()), this finds the longest suffix belonging to
+         * the original language.
+         *
+         * @tparam R Type of the input sequence.
+         * @param sequence The sequence to munch.
+         * @return Empty if no suffix matches, otherwise the length of the longest suffix.
+         */
+        template<std::ranges::bidirectional_range R>
+        requires range_of<R, T>
+        std::optional<std::size_t> munch_backward(R&& sequence) const noexcept {
+            return munch(std::views::reverse(std::forward<R>(sequence)));
+        }
+
+        /**
+         * @name Unanchored search
+         * @brief Finds the subsequences of a sequence which belong to \f$ \mathcal{L} \f$.
+         *
+         * The matches are leftmost-longest: the match starting first is chosen, and extended as far as possible.
+         * They are found in linear time, using two additional DFAs (built on first use):
+         * 1. A forward pass of a DFA for \f$ \Sigma^{*} \cdot \mathcal{L} \f$ finds the end of the last match;
+         * 2. A backward pass (from there) of a DFA for \f$ \Sigma^{*} \cdot \mathcal{L}^{R} \f$ finds the start of every match;
+         * 3. Each match is then extended using \ref munch(), bounded by the end of the last match.
+         *
+         * @note The sequences which are not bidirectional ranges are copied first.
+         * @{
+         */
+        /**
+         * @brief Finds the leftmost-longest match within the sequence.
+         * @return The match, if any.
+         */
+        template<input_range_of<T> R>
+        std::optional<Match> find(R&& sequence) const {
+            auto matches = search(sequence, true);
+            if(matches.empty()) {
+                return std::nullopt;
+            }
+            return matches.front();
+        }
+
+        /**
+         * @brief Finds all the non-overlapping leftmost-longest matches within the sequence, in order.
+         *
+         * The search resumes after the end of each match (or after its position, for empty matches).
+         */
+        template<input_range_of<T> R>
+        std::vector<Match> find_all(R&& sequence) const {
+            return search(sequence, false);
+        }
+        ///@}
+
         /**
          * @brief Allows DFA creation.
          */
@@ -518,6 +917,40 @@ namespace tfl {
                 return *this;
             }
 
+            /**
+             * @brief Makes this builder build a DFA for the reversed language
+             * \f$ \mathcal{L}^{R} = \left\{ (x_n, \ldots, x_1) \mid (x_1, \ldots, x_n) \in \mathcal{L} \right\} \f$.
+             *
+             * The transitions are reversed into a NFA, whose initial state leads to the
+             * (previously) accepting states through ε-transitions, which is then determinized.
+             * Undefined transitions are considered to lead into the dead state.
+             *
+             * @return This.
+             */
+            Builder& reverse() {
+                typename NFA<T>::Builder reversed(alphabet(), state_count() + 1);
+
+                auto is_live = [](OptStateIdx const& to){ return to.has_value() && to.value() != DEAD_STATE; };
+                for(StateIdx i = 0; i < state_count(); ++i) {
+                    for(auto const& [input, transitions]: _transitions) {
+                        if(is_live(transitions[i])) {
+                            reversed.add_transition(transitions[i].value() + 1, input, i + 1);
+                        }
+                    }
+                    if(is_live(_unknown_transitions[i])) {
+                        reversed.add_unknown_transition(_unknown_transitions[i].value() + 1, i + 1);
+                    }
+                    if(_accepting_states[i]) {
+                        reversed.add_epsilon_transition(0, i + 1);
+                    }
+                }
+                if(state_count() > 0) {
+                    reversed.set_acceptance(1, true);
+                }
+
+                return *this = reversed.make_deterministic();
+            }
+
             /**
              * @brief Sets all missing transitions.
              * @return This.
@@ -638,6 +1071,13 @@ namespace tfl {
     };
 
 
+    template<typename T>
+    struct DFA<T>::Search final {
+        std::once_flag built;
+        std::optional<DFA<T>> ends;
+        std::optional<DFA<T>> starts;
+    };
+
     /**
      * @brief <a href=https://en.wikipedia.org/wiki/Nondeterministic_finite_automaton>Nondeterministic Finite Automaton</a>.
      * 
@@ -684,7 +1124,7 @@ namespace tfl {
         using StateIndices = std::set<StateIdx>;
 
     private:
-        std::unordered_map<T, std::vector<StateIndices>> _transitions;
+        SymbolClasses<T, std::vector<StateIndices>> _transitions;
         std::vector<StateIndices> _unknown_transitions;
         std::vector<bool> _accepting_states;
 
@@ -695,10 +1135,9 @@ namespace tfl {
             return state;
         }
 
-        StateIndices transition_unchecked(StateIdx const& state, T const& x) const {
-            auto it =  _transitions.find(x);
-            if(it != _transitions.cend()) {
-                return it->second[state];
+        StateIndices const& transition_unchecked(StateIdx const& state, T const& x) const {
+            if(auto column = _transitions.find(x)) {
+                return (*column)[state];
             }
             else {
                 return _unknown_transitions[state];
@@ -707,7 +1146,7 @@ namespace tfl {
 
         template<std::ranges::input_range Tr, std::ranges::input_range Ut, std::ranges::input_range As>
         NFA(Tr&& transitions, Ut&& unknown_transitions, As&& accepting_states): 
-        _transitions(std::ranges::cbegin(transitions), std::ranges::cend(transitions)), 
+        _transitions(std::forward<Tr>(transitions)), 
         _unknown_transitions(std::ranges::cbegin(unknown_transitions), std::ranges::cend(unknown_transitions)), 
         _accepting_states(std::ranges::cbegin(accepting_states), std::ranges::cend(accepting_states)) {
             auto s = _unknown_transitions.size();
@@ -718,9 +1157,9 @@ namespace tfl {
             };
 
             check(_accepting_states, "accepting states");
-            for(auto p: _transitions) {
-                check(p.second, Stringify<T>::convert(p.first));
-            }
+            _transitions.for_each([&check](T const& x, auto const& column){
+                check(column, Stringify<T>::convert(x));
+            });
         }
 
     public:
@@ -748,9 +1187,8 @@ namespace tfl {
         StateIndices transition(StateIdx const& state, T const& x) const {
             check_state(state);
 
-            auto it =  _transitions.find(x);
-            if(it != _transitions.cend()) {
-                return it->second[state];
+            if(auto column = _transitions.find(x)) {
+                return (*column)[state];
             }
             else {
                 throw std::invalid_argument("Invalid input: " + Stringify<T>::convert(x));
@@ -769,7 +1207,15 @@ namespace tfl {
          * @brief Returns \f$ T^{-} \f$.
          */
         auto alphabet() const {
-            return transform_view(_transitions, [](auto p){ return p.first; });
+            return _transitions.symbols();
+        }
+
+        /**
+         * @brief Returns the number of classes of \f$ T^{-} \f$, whose symbols share all their transitions.
+         * @see \ref DFA::class_count()
+         */
+        std::size_t class_count() const {
+            return _transitions.class_count();
         }
 
         /**
@@ -1229,13 +1675,20 @@ namespace tfl {
             DFA<T>::Builder make_deterministic() {
                 epsilon_elimination();
 
+                // The symbols with the same transitions from every state lead to the same subsets,
+                // which are then only computed once per class of symbols.
+                std::map<std::vector<StateIndices>, std::vector<T>> classes;
+                for(auto const& [input, column]: _transitions) {
+                    classes[column].push_back(input);
+                }
+
                 auto inputs = std::ranges::transform_view(_transitions, [](auto p){ return p.first; });
-                auto transition = [this](std::vector<bool> state, T const& input) {
+                auto transition = [this](std::vector<bool> state, std::vector<StateIndices> const& column) {
                     std::vector<bool> out(state_count(), false);
 
                     for(StateIdx i = 0; i < state_count(); ++i) {
                         if(state[i]) {
-                            for(StateIdx j: _transitions.at(input)[i]) {
+                            for(StateIdx j: column[i]) {
                                 out[j] = true;
                             }
                         }
@@ -1283,15 +1736,17 @@ namespace tfl {
                     std::vector<bool> current = queue.front();
                     queue.pop();
 
-                    for(auto input: inputs) {
-                        std::vector<bool> to = transition(current, input);
+                    for(auto const& [column, symbols]: classes) {
+                        std::vector<bool> to = transition(current, column);
 
                         if(!indices.contains(to)) {
                             indices.emplace(to, builder.add_state().second);
                             queue.push(to);
                         }
 
-                        builder.set_transition(indices.at(current), input, indices.at(to));
+                        for(T const& input: symbols) {
+                            builder.set_transition(indices.at(current), input, indices.at(to));
+                        }
                     }
 
                     {
@@ -4,8 +4,17 @@
 #include "Regex.hpp"
 #include "RegexOps.hpp"
 
-#include <unordered_set>
+#include <limits>
 #include <numeric>
+#include <optional>
+#include <queue>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 /**
  * @brief Contains additional operations on automata. 
@@ -280,40 +289,361 @@ namespace tfl {
     };
 
     namespace {
+        // The automata of shared subexpressions are only built once, and released once melded into all their parents.
         template<typename T>
-        class RegexToNFA: public matchers::Base<T, typename NFA<T>::Builder> {
+        class RegexToNFA final: public matchers::MemoBase<T, typename NFA<T>::Builder> {
             using Builder = NFA<T>::Builder;
-            using matchers::Base<T, Builder>::rec;
         public:
-            Builder empty() const {
+            using matchers::MemoBase<T, Builder>::memo;
+
+            RegexToNFA(): matchers::MemoBase<T, Builder>(false) {}
+
+            Builder empty() {
                 return Automata<T>::empty();
             }
-            Builder epsilon() const {
+            Builder epsilon() {
                 return Automata<T>::epsilon();
             }
-            Builder alphabet() const {
+            Builder alphabet() {
                 return Automata<T>::alphabet();
             }
-            Builder literal(T const& literal) const {
+            Builder literal(T const& literal) {
                 return Automata<T>::literal(literal);
             }
-            Builder disjunction(Regex<T> const& left, Regex<T> const& right) const {
-                return Automata<T>::disjunction(rec(left), rec(right));
+            Builder disjunction(Regex<T> const& left, Regex<T> const& right) {
+                return Automata<T>::disjunction(memo(left), memo(right));
+            }
+            Builder sequence(Regex<T> const& left, Regex<T> const& right) {
+                return Automata<T>::sequence(memo(left), memo(right));
+            }
+            Builder kleene_star(Regex<T> const& regex) {
+                return Automata<T>::closure(memo(regex));
+            }
+            Builder complement(Regex<T> const& regex) {
+                return Automata<T>::complement(memo(regex));
+            }
+            Builder conjunction(Regex<T> const& left, Regex<T> const& right) {
+                return Automata<T>::conjunction(memo(left), memo(right));
+            }
+        };
+
+        // The positions of a (sub)regex, from 1: whether it accepts ε, the positions which may start or end its words.
+        struct Positions {
+            bool nullable;
+            std::vector<std::size_t> first;
+            std::vector<std::size_t> last;
+        };
+
+        // The literals of the regexes which are unions of literals (e.g. built by Regexes::range()).
+        template<typename T>
+        class LiteralSets final: public matchers::MemoBase<T, std::optional<std::vector<T>>> {
+            using Set = std::optional<std::vector<T>>;
+        public:
+            using matchers::MemoBase<T, Set>::memo;
+
+            Set empty() { return std::nullopt; }
+            Set epsilon() { return std::nullopt; }
+            Set alphabet() { return std::nullopt; }
+            Set literal(T const& literal) { return std::vector<T>{literal}; }
+            Set disjunction(Regex<T> const& left, Regex<T> const& right) {
+                Set const& l = memo(left);
+                Set const& r = memo(right);
+                if(!l || !r) {
+                    return std::nullopt;
+                }
+                std::vector<T> literals(*l);
+                literals.insert(literals.end(), r->begin(), r->end());
+                return literals;
+            }
+            Set sequence(Regex<T> const&, Regex<T> const&) { return std::nullopt; }
+            Set kleene_star(Regex<T> const&) { return std::nullopt; }
+            Set complement(Regex<T> const&) { return std::nullopt; }
+            Set conjunction(Regex<T> const&, Regex<T> const&) { return std::nullopt; }
+            Set capture(std::size_t, Regex<T> const&) { return std::nullopt; }
+            Set repetition(Regex<T> const&, std::size_t, std::size_t) { return std::nullopt; }
+        };
+
+        // Numbers the positions of a regex (the occurrences of Σ and of sets of literals), and records which positions 
+        // may follow each other. A union of literals is a single position, so that the symbols of a range share their
+        // transitions. Complements and conjunctions have no positions, so they are reported as unsupported.
+        template<typename T>
+        class PositionFinder final: public matchers::MutableBase<T, Positions> {
+            // The literals of each position (none for Σ), and the positions following it.
+            std::vector<std::optional<std::vector<T>>> _labels;
+            std::vector<std::vector<std::size_t>> _follow;
+            LiteralSets<T> _sets;
+            bool _supported = true;
+
+            Positions position(std::optional<std::vector<T>> const& label) {
+                _labels.push_back(label);
+                _follow.emplace_back();
+                return {false, {_labels.size()}, {_labels.size()}};
+            }
+
+            void link(std::vector<std::size_t> const& from, std::vector<std::size_t> const& to) {
+                for(std::size_t p: from) {
+                    _follow[p - 1].insert(_follow[p - 1].end(), to.begin(), to.end());
+                }
+            }
+
+            static std::vector<std::size_t> join(std::vector<std::size_t> left, std::vector<std::size_t> const& right) {
+                left.insert(left.end(), right.begin(), right.end());
+                return left;
+            }
+
+        public:
+            using matchers::MutableBase<T, Positions>::rec;
+
+            bool supported() const { return _supported; }
+            std::size_t position_count() const { return _labels.size(); }
+            std::optional<std::vector<T>> const& label(std::size_t p) const { return _labels[p - 1]; }
+            std::vector<std::size_t> const& follow(std::size_t p) const { return _follow[p - 1]; }
+
+            Positions empty() { return {false, {}, {}}; }
+            Positions epsilon() { return {true, {}, {}}; }
+            Positions alphabet() { return position(std::nullopt); }
+            Positions literal(T const& literal) { return position(std::vector<T>{literal}); }
+            Positions disjunction(Regex<T> const& left, Regex<T> const& right) {
+                if(_sets.memo(left) && _sets.memo(right)) {
+                    std::vector<T> literals(*_sets.memo(left));
+                    literals.insert(literals.end(), _sets.memo(right)->begin(), _sets.memo(right)->end());
+                    return position(literals);
+                }
+
+                Positions l = rec(left);
+                Positions r = rec(right);
+                return {l.nullable || r.nullable, join(std::move(l.first), r.first), join(std::move(l.last), r.last)};
+            }
+            Positions sequence(Regex<T> const& left, Regex<T> const& right) {
+                Positions l = rec(left);
+                Positions r = rec(right);
+                link(l.last, r.first);
+                return {
+                    l.nullable && r.nullable,
+                    l.nullable ? join(std::move(l.first), r.first) : std::move(l.first),
+                    r.nullable ? join(std::move(r.last), l.last) : std::move(r.last)
+                };
+            }
+            Positions kleene_star(Regex<T> const& regex) {
+                Positions r = rec(regex);
+                link(r.last, r.first);
+                return {true, std::move(r.first), std::move(r.last)};
+            }
+            Positions complement(Regex<T> const&) {
+                _supported = false;
+                return empty();
+            }
+            Positions conjunction(Regex<T> const&, Regex<T> const&) {
+                _supported = false;
+                return empty();
+            }
+        };
+
+        // Builds the Glushkov automaton of a regex, if it has no complement nor conjunction.
+        template<typename T>
+        std::optional<typename NFA<T>::Builder> make_position_automaton(Regex<T> const& regex) {
+            PositionFinder<T> finder;
+            Positions root = finder.rec(regex);
+            if(!finder.supported()) {
+                return std::nullopt;
+            }
+
+            auto alphabet = generate_minimal_alphabet(regex);
+            typename NFA<T>::Builder builder(alphabet, finder.position_count() + 1);
+
+            // Entering a position reads one of its literals (or anything, for Σ).
+            auto enter = [&](std::size_t from, std::size_t to) {
+                if(auto const& label = finder.label(to)) {
+                    for(T const& x: *label) {
+                        builder.add_transition(from, x, to);
+                    }
+                }
+                else {
+                    for(T const& x: alphabet) {
+                        builder.add_transition(from, x, to);
+                    }
+                    builder.add_unknown_transition(from, to);
+                }
+            };
+
+            for(std::size_t p: root.first) {
+                enter(0, p);
+            }
+            for(std::size_t p = 1; p <= finder.position_count(); ++p) {
+                for(std::size_t q: finder.follow(p)) {
+                    enter(p, q);
+                }
             }
-            Builder sequence(Regex<T> const& left, Regex<T> const& right) const {
-                return Automata<T>::sequence(rec(left), rec(right));
+
+            builder.set_acceptance(0, root.nullable);
+            builder.set_acceptance(root.last, true);
+            return builder;
+        }
+
+        // Builds the automaton whose states are the partial derivatives of a regex.
+        template<typename T>
+        typename NFA<T>::Builder make_partial_derivative_automaton(Regex<T> const& regex) {
+            using StateIdx = NFA<T>::StateIdx;
+
+            auto alphabet = generate_minimal_alphabet(regex);
+            std::vector<Regex<T>> terms{regex};
+            std::unordered_map<Regex<T>, StateIdx> states{{regex, 0}};
+            std::vector<std::tuple<StateIdx, std::optional<T>, StateIdx>> transitions;
+
+            auto state = [&](Regex<T> const& term) {
+                auto [it, added] = states.try_emplace(term, terms.size());
+                if(added) {
+                    terms.push_back(term);
+                }
+                return it->second;
+            };
+
+            // The vector of terms grows while they are derived.
+            for(StateIdx i = 0; i < terms.size(); ++i) {
+                Regex<T> term = terms[i];
+                for(T const& x: alphabet) {
+                    for(auto const& derivative: partial_derive(x, term)) {
+                        transitions.emplace_back(i, x, state(derivative));
+                    }
+                }
+                for(auto const& derivative: matchers::PartialDeriver<T, std::equal_to<T>>{nullptr}.sub(term)) {
+                    transitions.emplace_back(i, std::nullopt, state(derivative));
+                }
             }
-            Builder kleene_star(Regex<T> const& regex) const {
-                return Automata<T>::closure(rec(regex));
+
+            typename NFA<T>::Builder builder(alphabet, terms.size());
+            for(auto const& [from, x, to]: transitions) {
+                if(x) {
+                    builder.add_transition(from, *x, to);
+                }
+                else {
+                    builder.add_unknown_transition(from, to);
+                }
             }
-            Builder complement(Regex<T> const& regex) const {
-                return Automata<T>::complement(rec(regex));
+            for(StateIdx i = 0; i < terms.size(); ++i) {
+                builder.set_acceptance(i, terms[i].nullable());
             }
-            Builder conjunction(Regex<T> const& left, Regex<T> const& right) const {
-                return Automata<T>::conjunction(rec(left), rec(right));
+            return builder;
+        }
+
+        // The constructions used by a regex which have no positions: complements or conjunctions, and bounded repetitions.
+        struct Constructs {
+            bool boolean = false;
+            bool counted = false;
+
+            Constructs operator|(Constructs const& that) const {
+                return {boolean || that.boolean, counted || that.counted};
             }
         };
-        template<typename T> constexpr RegexToNFA<T> regex_to_nfa{};
+
+        template<typename T>
+        class ConstructFinder final: public matchers::MemoBase<T, Constructs> {
+        public:
+            using matchers::MemoBase<T, Constructs>::memo;
+
+            Constructs empty() { return {}; }
+            Constructs epsilon() { return {}; }
+            Constructs alphabet() { return {}; }
+            Constructs literal(T const&) { return {}; }
+            Constructs disjunction(Regex<T> const& left, Regex<T> const& right) { return memo(left) | memo(right); }
+            Constructs sequence(Regex<T> const& left, Regex<T> const& right) { return memo(left) | memo(right); }
+            Constructs kleene_star(Regex<T> const& regex) { return memo(regex); }
+            Constructs complement(Regex<T> const& regex) { return memo(regex) | Constructs{true, false}; }
+            Constructs conjunction(Regex<T> const& left, Regex<T> const& right) { return memo(left) | memo(right) | Constructs{true, false}; }
+            Constructs repetition(Regex<T> const& regex, std::size_t, std::size_t) { return memo(regex) | Constructs{false, true}; }
+        };
+
+        // Tests whether every word of `dfa` (but ε, if `nonempty`) is accepted by one of the `covers`, exploring their 
+        // product on the fly: the exploration stops at the first word accepted by `dfa` and none of the `covers`.
+        template<typename T>
+        bool is_covered(DFA<T> const& dfa, std::vector<DFA<T> const*> const& covers, bool nonempty = false) {
+            using StateIdx = DFA<T>::StateIdx;
+            using States = std::vector<StateIdx>;
+
+            std::unordered_set<T> inputs;
+            for(DFA<T> const* automaton: covers) {
+                auto alphabet = automaton->alphabet();
+                inputs.insert(std::ranges::begin(alphabet), std::ranges::end(alphabet));
+            }
+            auto alphabet = dfa.alphabet();
+            inputs.insert(std::ranges::begin(alphabet), std::ranges::end(alphabet));
+
+            // The values which are not in any alphabet follow the unknown transitions, unless there is no such value.
+            bool unknown = true;
+            if constexpr(std::integral<T> && sizeof(T) < sizeof(std::size_t)) {
+                unknown = inputs.size() < (std::size_t{1} << (std::numeric_limits<T>::digits + std::is_signed_v<T>));
+            }
+
+            auto successors = [&](States const& states) {
+                std::vector<States> next;
+                auto step = [&](auto const& transition) {
+                    States to;
+                    to.push_back(transition(dfa, states[0]));
+                    for(std::size_t i = 0; i < covers.size(); ++i) {
+                        to.push_back(transition(*covers[i], states[i + 1]));
+                    }
+                    next.push_back(std::move(to));
+                };
+                for(T const& x: inputs) {
+                    step([&x](DFA<T> const& automaton, StateIdx state){ return automaton.step(state, x); });
+                }
+                if(unknown) {
+                    step([](DFA<T> const& automaton, StateIdx state){ return automaton.unknown_transition(state); });
+                }
+                return next;
+            };
+
+            States initial(covers.size() + 1, 0);
+            std::set<States> visited;
+            std::queue<States> queue;
+            if(nonempty) {
+                for(States& states: successors(initial)) {
+                    queue.push(std::move(states));
+                }
+            }
+            else {
+                queue.push(std::move(initial));
+            }
+
+            while(!queue.empty()) {
+                States states = std::move(queue.front());
+                queue.pop();
+                // No word of `dfa` goes through its dead state.
+                if(states[0] == DFA<T>::DEAD_STATE || !visited.insert(states).second) {
+                    continue;
+                }
+
+                bool covered = !dfa.is_accepting(states[0]);
+                for(std::size_t i = 0; !covered && i < covers.size(); ++i) {
+                    covered = covers[i]->is_accepting(states[i + 1]);
+                }
+                if(!covered) {
+                    return false;
+                }
+
+                for(States& next: successors(states)) {
+                    if(!visited.contains(next)) {
+                        queue.push(std::move(next));
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Determinizes the smallest NFA which can be built without unrolling the regex: the Glushkov automaton
+        // if the regex has positions only, the partial-derivative automaton (which counts the repetitions) 
+        // if it has bounded repetitions, and the Thompson automaton otherwise.
+        template<typename T>
+        typename DFA<T>::Builder make_dfa_builder(Regex<T> const& regex) {
+            Constructs constructs = ConstructFinder<T>().memo(regex);
+            if(!constructs.boolean && !constructs.counted) {
+                return make_position_automaton(regex)->make_deterministic();
+            }
+            else if(!constructs.boolean) {
+                return make_partial_derivative_automaton(regex).make_deterministic();
+            }
+            return RegexToNFA<T>().memo(regex).make_deterministic();
+        }
 
     }
 
@@ -326,7 +656,40 @@ namespace tfl {
      */
     template<typename T>
     NFA<T> make_nfa(Regex<T> const& regex) {
-        return regex.match(regex_to_nfa<T>);
+        return RegexToNFA<T>().memo(regex);
+    }
+
+    /**
+     * @brief Converts a regex into its Glushkov (or position) automaton, an equivalent NFA without ε-transitions.
+     *
+     * The automaton has an initial state, plus one state per position of the regex (i.e. per occurrence of \f$ \Sigma \f$
+     * or of a union of literals, such as a range), entered by reading one of the literals of the position. It is built directly from the positions 
+     * which may start, end and follow each other in the words, so no ε-elimination is needed.
+     *
+     * @tparam T Type of literals.
+     * @exception std::invalid_argument If the regex contains a complement or a conjunction, which have no positions.
+     */
+    template<typename T>
+    NFA<T> make_glushkov_nfa(Regex<T> const& regex) {
+        if(auto positions = make_position_automaton(regex)) {
+            return *positions;
+        }
+        throw std::invalid_argument("Glushkov automata cannot be built from complements nor conjunctions");
+    }
+
+    /**
+     * @brief Converts a regex into its partial-derivative (or Antimirov) automaton, an equivalent NFA without ε-transitions.
+     *
+     * The states are the partial derivatives of the regex w.r.t. all strings (see \ref partial_derive()), starting 
+     * from the regex itself, and accepting if nullable. The automaton is usually smaller than the Glushkov automaton
+     * (see \ref make_glushkov_nfa()), since the partial derivatives are identified by structural equality.
+     * Complements and conjunctions are supported, but the complement of a union is a single state.
+     *
+     * @tparam T Type of literals.
+     */
+    template<typename T>
+    NFA<T> make_nfa_by_partial_derivatives(Regex<T> const& regex) {
+        return make_partial_derivative_automaton(regex);
     }
 
     /**
@@ -334,10 +697,87 @@ namespace tfl {
      * 
      * \f[ \mathcal{L} = \mathcal{L}(R) \f]
      *
+     * The DFA is determinized from the Glushkov automaton of the regex (see \ref make_glushkov_nfa()), 
+     * or from its partial-derivative automaton if it contains bounded repetitions (see \ref make_nfa_by_partial_derivatives()),
+     * unless it contains a complement or a conjunction.
+     *
      * @tparam T Type of literals.
      */
     template<typename T>
     DFA<T> make_dfa(Regex<T> const& regex) {
-        return regex.match(regex_to_nfa<T>).make_deterministic();
+        return make_dfa_builder(regex);
+    }
+
+    /**
+     * @brief Converts a regex into a DFA accepting the reversed sequences.
+     * 
+     * \f[ \mathcal{L} = \mathcal{L}(R)^{R} \f]
+     *
+     * @tparam T Type of literals.
+     * @see \ref DFA::Builder::reverse(), \ref DFA::munch_backward()
+     */
+    template<typename T>
+    DFA<T> make_reverse_dfa(Regex<T> const& regex) {
+        return make_dfa_builder(regex).reverse();
+    }
+
+    /**
+     * @brief Tests whether the language of a DFA is included in the language of another.
+     *
+     * \f[ \mathcal{L}(L) \subseteq \mathcal{L}(R) \f]
+     *
+     * The product of the DFAs is explored on the fly, from their initial states, and the exploration stops
+     * at the first word accepted by \f$ L \f$ but not by \f$ R \f$. Hence, the product is only built entirely
+     * if the inclusion holds.
+     *
+     * @tparam T Type of literals.
+     */
+    template<typename T>
+    bool is_subset(DFA<T> const& left, DFA<T> const& right) {
+        return is_covered(left, {&right});
+    }
+
+    /**
+     * @brief Tests whether the language of a regex is included in the language of another.
+     *
+     * \f[ \mathcal{L}(L) \subseteq \mathcal{L}(R) \f]
+     *
+     * @tparam T Type of literals.
+     * @see \ref is_subset(DFA<T> const&, DFA<T> const&)
+     */
+    template<typename T>
+    bool is_subset(Regex<T> const& left, Regex<T> const& right) {
+        return left == right || is_subset(make_dfa(left), make_dfa(right));
+    }
+
+    /**
+     * @brief Tests whether two DFAs have the same language.
+     *
+     * \f[ \mathcal{L}(L) = \mathcal{L}(R) \f]
+     *
+     * @tparam T Type of literals.
+     * @see \ref is_subset(DFA<T> const&, DFA<T> const&)
+     */
+    template<typename T>
+    bool is_equivalent(DFA<T> const& left, DFA<T> const& right) {
+        return is_subset(left, right) && is_subset(right, left);
+    }
+
+    /**
+     * @brief Tests whether two regexes have the same language, i.e. \f$ L \equiv R \f$.
+     *
+     * \f[ \mathcal{L}(L) = \mathcal{L}(R) \f]
+     *
+     * @tparam T Type of literals.
+     * @see \ref is_subset(DFA<T> const&, DFA<T> const&)
+     */
+    template<typename T>
+    bool is_equivalent(Regex<T> const& left, Regex<T> const& right) {
+        if(left == right) {
+            return true;
+        }
+        DFA<T> l = make_dfa(left);
+        DFA<T> r = make_dfa(right);
+        return is_subset(l, r) && is_subset(r, l);
     }
 }
\ No newline at end of file
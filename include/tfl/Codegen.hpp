@@ -0,0 +1,239 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <map>
+#include <set>
+#include <concepts>
+#include <initializer_list>
+
+#include "Automata.hpp"
+
+/**
+ * @brief Contains functions to generate C++ code implementing DFAs.
+ * @file
+ */
+
+namespace tfl {
+
+    namespace {
+
+        template<typename T>
+        struct SourceWrapper final {
+            std::string name;
+            std::vector<std::pair<std::string, DFA<T>>> dfas;
+        };
+
+        // Groups the equivalent states of a DFA (Moore's algorithm), so that each group is only emitted once.
+        // The group of the initial state is 0, and the dead state is its own group.
+        template<typename T>
+        std::vector<std::size_t> equivalent_states(DFA<T> const& dfa) {
+            using StateIdx = DFA<T>::StateIdx;
+            static constexpr StateIdx DEAD_STATE = DFA<T>::DEAD_STATE;
+
+            std::vector<std::size_t> groups(dfa.state_count());
+            for(StateIdx i = 0; i < dfa.state_count(); ++i) {
+                groups[i] = dfa.is_accepting(i) ? 1 : 0;
+            }
+
+            auto group_of = [&groups](StateIdx state){ return state == DEAD_STATE ? DEAD_STATE : groups[state]; };
+            std::size_t count = 0;
+            while(true) {
+                std::map<std::vector<std::size_t>, std::size_t> signatures;
+                std::vector<std::size_t> refined(dfa.state_count());
+                for(StateIdx i = 0; i < dfa.state_count(); ++i) {
+                    std::vector<std::size_t> signature{groups[i], group_of(dfa.unknown_transition(i))};
+                    for(auto input: dfa.alphabet()) {
+                        signature.push_back(group_of(dfa.transition(i, input)));
+                    }
+                    refined[i] = signatures.emplace(std::move(signature), signatures.size()).first->second;
+                }
+
+                groups = std::move(refined);
+                if(signatures.size() == count) {
+                    break;
+                }
+                count = signatures.size();
+            }
+
+            // Renumbers the groups so that the initial state belongs to group 0.
+            if(!groups.empty() && groups[0] != 0) {
+                std::size_t initial = groups[0];
+                for(auto& g: groups) {
+                    g = (g == initial) ? 0 : (g == 0 ? initial : g);
+                }
+            }
+
+            return groups;
+        }
+
+        // Emits a direct-coded version of DFA::munch: each state is a label, and each
+        // transition a `goto` selected by a `switch` on the current input.
+        template<typename T>
+        void emit_munch(std::ostream& stream, std::string const& name, DFA<T> const& dfa) {
+            using StateIdx = DFA<T>::StateIdx;
+            static constexpr StateIdx DEAD_STATE = DFA<T>::DEAD_STATE;
+
+            auto groups = equivalent_states(dfa);
+            auto group_of = [&groups](StateIdx state){ return state == DEAD_STATE ? DEAD_STATE : groups[state]; };
+
+            // For each group, a representative state, and the inputs leading to each group.
+            std::map<std::size_t, StateIdx> representatives;
+            for(StateIdx i = 0; i < dfa.state_count(); ++i) {
+                representatives.emplace(groups[i], i);
+            }
+            std::map<std::size_t, std::map<StateIdx, std::set<T>>> cases;
+            std::set<StateIdx> targets;
+            for(auto const& [group, state]: representatives) {
+                StateIdx unknown = group_of(dfa.unknown_transition(state));
+                targets.insert(unknown);
+                cases[group];
+                for(auto input: dfa.alphabet()) {
+                    StateIdx to = group_of(dfa.transition(state, input));
+                    if(to != unknown) {
+                        cases[group][to].insert(input);
+                        targets.insert(to);
+                    }
+                }
+            }
+
+            stream << "    template<typename It, typename S>\n";
+            stream << "    std::optional<std::size_t> munch_" << name << "([[maybe_unused]] It it, [[maybe_unused]] S end) {\n";
+            stream << "        std::optional<std::size_t> last;\n";
+            stream << "        [[maybe_unused]] std::size_t length = 0;\n";
+
+            for(auto const& [group, state]: representatives) {
+                stream << '\n';
+                if(targets.contains(group)) {
+                    stream << "    s" << group << ":\n";
+                }
+                if(dfa.is_accepting(state)) {
+                    stream << "        last = length;\n";
+                }
+
+                StateIdx unknown = group_of(dfa.unknown_transition(state));
+                if(cases[group].empty() && unknown == DEAD_STATE) {
+                    stream << "        return last;\n";
+                    continue;
+                }
+
+                stream << "        if(it == end) {\n";
+                stream << "            return last;\n";
+                stream << "        }\n";
+                stream << "        ++length;\n";
+
+                if(cases[group].empty()) {
+                    stream << "        ++it;\n";
+                    stream << "        goto s" << unknown << ";\n";
+                    continue;
+                }
+
+                stream << "        switch(*it++) {\n";
+                for(auto const& [to, inputs]: cases[group]) {
+                    stream << "           ";
+                    for(T const& input: inputs) {
+                        stream << " case " << +input << ':';
+                    }
+                    stream << '\n';
+                    if(to == DEAD_STATE) {
+                        stream << "                return last;\n";
+                    }
+                    else {
+                        stream << "                goto s" << to << ";\n";
+                    }
+                }
+                stream << "            default:\n";
+                if(unknown == DEAD_STATE) {
+                    stream << "                return last;\n";
+                }
+                else {
+                    stream << "                goto s" << unknown << ";\n";
+                }
+                stream << "        }\n";
+            }
+
+            stream << "    }\n";
+        }
+
+        /**
+         * @brief Outputs the source code generated by \ref cpp_source() to a stream.
+         */
+        template<typename T>
+        std::ostream& operator<<(std::ostream& stream, SourceWrapper<T> const& wsource) {
+            stream << "// Generated by tfl::cpp_source, do not edit.\n";
+            stream << "#pragma once\n\n";
+            stream << "#include <cstddef>\n";
+            stream << "#include <optional>\n";
+            stream << "#include <ranges>\n\n";
+            stream << "namespace " << wsource.name << " {\n\n";
+
+            for(auto const& [id, dfa]: wsource.dfas) {
+                emit_munch(stream, id, dfa);
+                stream << '\n';
+            }
+
+            stream << "    struct Automaton {\n";
+            stream << "        std::size_t index;\n\n";
+            stream << "        template<std::ranges::input_range R>\n";
+            stream << "        std::optional<std::size_t> munch(R&& sequence) const {\n";
+            stream << "            switch(index) {\n";
+            for(std::size_t i = 0; i < wsource.dfas.size(); ++i) {
+                stream << "                case " << i << ": return munch_" << wsource.dfas[i].first;
+                stream << "(std::ranges::begin(sequence), std::ranges::end(sequence));\n";
+            }
+            stream << "            }\n";
+            stream << "            return std::nullopt;\n";
+            stream << "        }\n";
+            stream << "    };\n\n";
+
+            for(std::size_t i = 0; i < wsource.dfas.size(); ++i) {
+                stream << "    inline constexpr Automaton " << wsource.dfas[i].first << "{" << i << "};\n";
+            }
+
+            stream << "}\n";
+
+            return stream;
+        }
+    }
+
+    /**
+     * @name C++ source generation
+     * @brief Generates a C++ header implementing some DFAs, which can then be outputed.
+     *
+     * Each DFA is implemented as a direct-coded state machine (one label per state, and a `switch` selecting
+     * the next state), which is faster than walking the transition tables of a \ref DFA,
+     * and does not require any construction at runtime.
+     *
+     * The generated header defines, within namespace `name`:
+     * - For each DFA `id`, `template<typename It, typename S> std::optional<std::size_t> munch_id(It it, S end)`,
+     * equivalent to \ref DFA::munch;
+     * - A type `Automaton`, whose `munch` member function behaves like \ref DFA::munch, and can therefore
+     * be used in a \ref Rule;
+     * - For each DFA `id`, a constant `Automaton id`.
+     *
+     * The names must be valid C++ identifiers, and the input elements of the generated functions must
+     * be of type `T`.
+     *
+     * @note As for \ref dot_graph(), these functions are only used to indicate that the subsequent
+     * call to `operator<<` should output the source code.
+     * \code{.cpp}
+     * // Correct usage:
+     * std::cout << cpp_source("scanner", {{"number", make_dfa(number)}, {"space", make_dfa(space)}}) << std::endl;
+     * \endcode
+     *
+     * @tparam T Type of the alphabet. Must be integral.
+     * @{
+     */
+    template<std::integral T>
+    auto cpp_source(std::string const& name, std::vector<std::pair<std::string, DFA<T>>> const& dfas) {
+        return SourceWrapper<T>{name, dfas};
+    }
+
+    template<std::integral T>
+    auto cpp_source(std::string const& name, std::initializer_list<std::pair<std::string, DFA<T>>> dfas) {
+        return SourceWrapper<T>{name, dfas};
+    }
+    ///@}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Contains the description of input edits, shared by incremental lexers and parsers.
+ * @file
+ */
+
+namespace tfl {
+
+    /**
+     * @brief Describes an edit of some input: `removed` values starting at `position` were replaced by `inserted` values.
+     * @see \ref Lexer::relex(), \ref IncrementalParser::reparse()
+     */
+    struct Edit final {
+        /**
+         * @brief Position of the first modified value.
+         */
+        std::size_t position;
+
+        /**
+         * @brief Number of values removed from the input.
+         */
+        std::size_t removed;
+
+        /**
+         * @brief Number of values inserted in place of the removed ones.
+         */
+        std::size_t inserted;
+
+        bool operator==(Edit const&) const = default;
+    };
+}
@@ -3,17 +3,25 @@
 #include "Regex.hpp"
 #include "Automata.hpp"
 #include "AutomataOps.hpp"
+#include "Serialization.hpp"
+#include "StaticDFA.hpp"
 #include "InputBuffer.hpp"
 #include "Concepts.hpp"
+#include "Edit.hpp"
+#include "LineIndex.hpp"
+#include "TaggedDFA.hpp"
 
 #include <vector>
 #include <functional>
 #include <iterator>
+#include <map>
+#include <memory>
 #include <optional>
 #include <type_traits>
 #include <stdexcept>
 #include <concepts>
 #include <ranges>
+#include <span>
 
 /**
  * @brief Contains the definition of the \ref Lexer
@@ -36,17 +44,115 @@ namespace tfl {
     template<typename, typename> class Lexer;
     template<typename, typename, typename> class Rule;
 
+    namespace {
+        template<typename, class, typename> class SimpleLexerBase;
+        template<typename, typename> class SimpleDerivationLexer;
+    }
+
+    /**
+     * @brief Specifies that a type can be used by a lexer as it would use a \ref DFA.
+     *
+     * Such automata find the longest prefix of the input they accept, using `munch` (see \ref DFA::munch()).
+     * 
+     * @tparam A The automaton type.
+     * @tparam T The alphabet type.
+     */
+    template<typename A, typename T>
+    concept prefix_automaton = std::copy_constructible<A> && requires(
+        A const& a, 
+        std::ranges::subrange<typename InputBuffer<T>::Iterator, typename InputBuffer<T>::Sentinel> input
+    ) {
+        { a.munch(input) } -> std::same_as<std::optional<std::size_t>>;
+    };
+
     /**
-     * @brief Wraps a type and associated it with a start position.
+     * @brief Wraps a type and associates it with its position in the input.
+     * 
+     * The values produced by a lexer record their offset and length in the input. Their line and column
+     * are computed on demand, from the \ref LineIndex of the input (shared by all the values lexed from it).
      * 
      * @tparam T Wrapped type.
-     * @todo Add an end position, as well as a token position.
      */
     template<typename T>
     class Positioned {
+        template<typename, typename, typename> friend class SimpleLexerBase;
+
+        // The lines of a lexed input, and the edits of the input which are not applied yet to the offsets
+        // of the values lexed from it (see Lexer::relex()).
+        struct Input {
+            // Beyond this number of edits, they are applied to the offsets of the values.
+            static constexpr std::size_t MAX_EDITS = 64;
+
+            LineIndex lines;
+            // The number of edits already applied, before `edits`.
+            std::size_t epoch = 0;
+            std::vector<Edit> edits;
+
+            // The number of edits of the input.
+            std::size_t current() const {
+                return epoch + edits.size();
+            }
+
+            // Applies the edits following `from` to an offset (`reach` = false) or a reach. The values are never in an
+            // edited span (they are relexed), but the reach of a value before an insertion may end where it starts.
+            std::size_t shifted(std::size_t offset, std::size_t from, bool reach) const {
+                for(auto it = edits.cbegin() + (from - epoch); it != edits.cend(); ++it) {
+                    if(reach ? offset > it->position : offset >= it->position + it->removed) {
+                        offset = offset - it->removed + it->inserted;
+                    }
+                }
+                return offset;
+            }
+
+            // Returns the offsets (or the reaches) of the first epoch from which each edit applies, with its shift,
+            // in increasing order. As the shifted values increase, these are the smallest values the edit applies to,
+            // mapped back through the earlier edits.
+            std::vector<std::pair<std::size_t, std::ptrdiff_t>> thresholds(bool reach) const {
+                std::vector<std::pair<std::size_t, std::ptrdiff_t>> result;
+                for(std::size_t k = 0; k < edits.size(); ++k) {
+                    std::size_t value = edits[k].position + (reach ? 1 : edits[k].removed);
+                    for(std::size_t j = k; j-- > 0;) {
+                        Edit const& edit = edits[j];
+                        std::size_t end = edit.position + edit.removed + (reach ? 1 : 0);
+                        if(value >= edit.position + (reach ? 1 : 0)) {
+                            value = (value + edit.removed >= end + edit.inserted) ? value + edit.removed - edit.inserted : end;
+                        }
+                    }
+                    result.emplace_back(value, static_cast<std::ptrdiff_t>(edits[k].inserted) - static_cast<std::ptrdiff_t>(edits[k].removed));
+                }
+                std::ranges::sort(result);
+                return result;
+            }
+        };
+
         T _val;
-        size_t _line;
-        size_t _column;
+        size_t _offset = 0;
+        size_t _length = 0;
+        // Offset up to which the lexer read values to produce this value or an earlier one, so that it
+        // increases along the values (see Lexer::relex()).
+        size_t _reach = 0;
+        // The number of edits of the input applied to the offset and the reach.
+        size_t _epoch = 0;
+        // Null if the line and the column were given explicitly.
+        std::shared_ptr<Input> _input;
+        size_t _line = 0;
+        size_t _column = 0;
+
+        template<typename... Args>
+        Positioned(Match span, std::shared_ptr<Input> const& input, Args&&... args): 
+        _val(std::forward<Args>(args)...), _offset(span.position), _length(span.length), _epoch(input->current()), _input(input) {}
+
+        size_t reach() const {
+            return _input ? _input->shifted(_reach, _epoch, true) : _reach;
+        }
+
+        // Applies the pending edits of the input to the offset and the reach.
+        void update() {
+            size_t offset = this->offset();
+            _reach = reach();
+            _offset = offset;
+            _epoch = _input ? _input->current() : 0;
+        }
 
     public:
         /**
@@ -79,60 +185,327 @@ namespace tfl {
          * @brief The line where the value starts.
          */
         size_t line() const {
-            return _line;
+            return _input ? _input->lines.line(offset()) : _line;
         }
 
         /**
          * @brief The column where the value starts.
          */
         size_t column() const {
-            return _column;
+            return _input ? _input->lines.position(offset()).second : _column;
+        }
+
+        /**
+         * @brief The line where the value ends (that of the first value after it).
+         */
+        size_t end_line() const {
+            return _input ? _input->lines.line(offset() + _length) : _line;
+        }
+
+        /**
+         * @brief The column where the value ends (that of the first value after it).
+         */
+        size_t end_column() const {
+            return _input ? _input->lines.position(offset() + _length).second : _column;
+        }
+
+        /**
+         * @brief The line starts of the input, null if the position was given explicitly.
+         * 
+         * Allows to map any other offset of the input (an error's, for instance) to its line and column.
+         */
+        std::shared_ptr<LineIndex const> line_index() const {
+            return _input ? std::shared_ptr<LineIndex const>(_input, &_input->lines) : nullptr;
+        }
+
+        /**
+         * @brief The offset of the value in the input.
+         */
+        size_t offset() const {
+            return _input ? _input->shifted(_offset, _epoch, false) : _offset;
+        }
+
+        /**
+         * @brief The length of the subsequence of the input spanned by the value.
+         */
+        size_t length() const {
+            return _length;
         }
 
         /**
          * @return True if the position and the wrapped value are equal.
          */
         bool operator== (Positioned const& that) const {
-            return (this->_line == that._line)
-                && (this->_column == that._column)
+            return (this->line() == that.line())
+                && (this->column() == that.column())
                 && (this->_val == that._val);
         }
     };
 
     namespace {
 
+        // The type wrapped by a positioned type.
+        template<typename R>
+        struct PositionedValue {
+            using type = R;
+        };
+
+        template<typename R>
+        struct PositionedValue<Positioned<R>> {
+            using type = R;
+        };
+
         template<typename T, typename R>
         class LexerBase {
         public:
+            using Unlexable = std::ranges::subrange<typename InputBuffer<T>::Iterator>;
+
             virtual ~LexerBase() = default;
             virtual std::vector<R> apply (InputBuffer<T>&) const = 0;
+
+            virtual std::vector<R> apply(std::span<T const> input) const {
+                InputBuffer<T> buffer(input);
+                return apply(buffer);
+            }
+
+            virtual Edit relex(std::vector<R>&, Edit const&, std::span<T const>) const {
+                throw LexingException("Mapped or filtered lexers cannot relex their input.");
+            }
+
+            virtual std::shared_ptr<LexerBase> recovering(std::function<typename PositionedValue<R>::type(Unlexable)> const&) const {
+                throw LexingException("Mapped or filtered lexers cannot recover from errors.");
+            }
+
+            virtual std::vector<std::size_t> pruned_rules() const {
+                return {};
+            }
         };
 
+        // The values which may start a newline (none if any value may), and whether each of them is a whole newline.
+        template<typename T>
+        struct NewlineStarts {
+            std::optional<std::vector<T>> firsts;
+            bool single = false;
+        };
+
+        template<typename T>
+        NewlineStarts<T> newline_starts(DFA<T> const& dfa) {
+            if(dfa.unknown_transition(0) != DFA<T>::DEAD_STATE) {
+                return {};
+            }
+
+            auto is_final = [&dfa](auto state) {
+                return dfa.is_accepting(state) 
+                    && dfa.unknown_transition(state) == DFA<T>::DEAD_STATE
+                    && std::ranges::all_of(dfa.alphabet(), [&](auto const& x){ return dfa.transition(state, x) == DFA<T>::DEAD_STATE; });
+            };
+
+            NewlineStarts<T> starts{std::vector<T>(), true};
+            for(auto const& x: dfa.alphabet()) {
+                if(auto state = dfa.transition(0, x); state != DFA<T>::DEAD_STATE) {
+                    starts.firsts->push_back(x);
+                    starts.single = starts.single && is_final(state);
+                }
+            }
+            return starts;
+        }
+
+        // Finds the first position (after the first one) from which one of the DFAs accepts a nonempty prefix,
+        // and returns the length of the input if there is none.
+        // The DFAs are run from every position in a single pass: each of their states is only kept with the earliest
+        // position it was reached from, and the pass ends once no state reached from an earlier position is left.
+        template<typename T, typename It, typename S>
+        std::size_t next_match(std::vector<DFA<T>> const& dfas, It it, S end) {
+            using Thread = std::pair<std::size_t, typename DFA<T>::StateIdx>;
+
+            std::map<Thread, std::size_t> threads, next;
+            std::optional<std::size_t> first;
+            std::size_t position = 1;
+            for(++it; it != end; ++it, ++position) {
+                if(!first.has_value()) {
+                    for(std::size_t i = 0; i < dfas.size(); ++i) {
+                        threads.try_emplace(Thread{i, 0}, position);
+                    }
+                }
+                else if(threads.empty()) {
+                    break;
+                }
+
+                next.clear();
+                for(auto const& [thread, start]: threads) {
+                    auto state = dfas[thread.first].step(thread.second, *it);
+                    if(state == DFA<T>::DEAD_STATE) {
+                        continue;
+                    }
+                    if(dfas[thread.first].is_accepting(state)) {
+                        first = std::min(first.value_or(start), start);
+                    }
+
+                    auto [pos, inserted] = next.try_emplace(Thread{thread.first, state}, start);
+                    pos->second = std::min(pos->second, start);
+                }
+
+                threads.swap(next);
+                std::erase_if(threads, [&first](auto const& thread){ return first.has_value() && thread.second >= *first; });
+            }
+
+            return first.value_or(position);
+        }
+
         template<typename T, class M, typename R>
         class SimpleLexerBase : public LexerBase<T, Positioned<R>> {
+            using Unlexable = LexerBase<T, Positioned<R>>::Unlexable;
+            using Input = typename Positioned<R>::Input;
+
+            // Maps the unlexable values, if the lexer recovers from errors.
+            std::function<R(Unlexable)> _error;
+            // Automata whose union accepts the languages of the rules (empty if the rules are tried one by one).
+            std::vector<DFA<T>> _resync;
+
+            // The number of values from `beg` to the next position where a rule applies.
+            std::size_t unlexable(InputBuffer<T>::Iterator beg, InputBuffer<T>::Sentinel end) const {
+                if(!_resync.empty()) {
+                    return next_match(_resync, beg, end);
+                }
+
+                std::size_t length = 1;
+                for(++beg; beg != end; ++beg, ++length) {
+                    if(std::ranges::any_of(rules(), [&](auto const& rule){ return maximal(rule.matcher(), beg, end).has_value(); })) {
+                        break;
+                    }
+                }
+                return length;
+            }
+
         protected:
+            virtual std::shared_ptr<SimpleLexerBase> copy() const = 0;
+            virtual std::vector<DFA<T>> combined() const = 0;
             virtual std::vector<Rule<T, M, R>> const& rules() const = 0;
             virtual M const& newline() const = 0;
-            virtual std::optional<typename InputBuffer<T>::Iterator::difference_type> maximal(M matcher, InputBuffer<T>::Iterator beg, InputBuffer<T>::Sentinel end) const = 0;
+            virtual NewlineStarts<T> const& newline_starts() const = 0;
+            // The matchers are borrowed: lexing does not copy them.
+            virtual std::optional<Submatches> maximal(M const& matcher, InputBuffer<T>::Iterator beg, InputBuffer<T>::Sentinel end) const = 0;
 
-        public:
+            // Adds the starts of the lines to the index, from `scanned` (the offset up to which the newlines
+            // were already found) to `until`. `cur` is the iterator at `offset`.
+            void scan_lines(InputBuffer<T>::Iterator const& cur, size_t offset, size_t& scanned, size_t until, InputBuffer<T>::Sentinel end, LineIndex& lines) const {
+                M const& nl = newline();
+                std::optional<std::vector<T>> const& firsts = newline_starts().firsts;
+                if(firsts.has_value() && firsts->empty()) {
+                    scanned = std::max(scanned, until);
+                    return;
+                }
 
-            virtual std::vector<Positioned<R>> apply(InputBuffer<T>& input) const final override {
-                std::vector<Positioned<R>> output;
-                auto cur = input.begin();
+                // Only the values which may start a newline are tested.
+                auto it = cur;
+                std::advance(it, scanned - offset);
+                while(scanned < until) {
+                    if(!firsts.has_value() || std::ranges::find(*firsts, *it) != firsts->cend()) {
+                        if(auto length = maximal(nl, it, end)) {
+                            scanned += length->length;
+                            std::advance(it, length->length);
+                            lines.add_line(scanned);
+                            continue;
+                        }
+                    }
+                    ++scanned;
+                    ++it;
+                }
+            }
 
-                size_t col = 1;
-                size_t line = 1;
+            // Indexes the lines of the whole input, with a vectorized search when the newlines are single bytes.
+            void index_lines(std::span<T const> input, LineIndex& lines) const {
+                if constexpr(byte_like<T>) {
+                    NewlineStarts<T> const& starts = newline_starts();
+                    if(starts.single) {
+                        ByteSet newlines;
+                        if(std::ranges::all_of(*starts.firsts, [&newlines](T x){ return newlines.insert(static_cast<unsigned char>(x)); })) {
+                            lines = LineIndex::of(input, newlines);
+                            return;
+                        }
+                    }
+                }
+
+                lines = LineIndex();
+                InputBuffer<T> buffer(input);
+                size_t scanned = 0;
+                scan_lines(buffer.begin(), 0, scanned, input.size(), buffer.end(), lines);
+            }
+
+            // Indexes the lines of the edited input from the index before the edit, or returns nothing if no line changed.
+            // The line starts before the line of the edit are kept, and the newlines are searched from it until a line
+            // starts where a line started before the edit (after it): the following line starts are shifted by the edit.
+            std::optional<LineIndex> reindex_lines(LineIndex const& old, Edit const& edit, std::span<T const> input) const {
+                std::optional<std::vector<T>> const& firsts = newline_starts().firsts;
+                if(firsts.has_value() && firsts->empty()) {
+                    return std::nullopt;
+                }
+
+                // A newline ending at the edit may be extended by it, hence the line of the value before the edit.
+                size_t line = old.line(edit.position > 0 ? edit.position - 1 : 0);
+                size_t from = old.line_start(line);
+                size_t new_end = edit.position + edit.inserted;
+
+                // The line starts found from `from`, after the dummy first one.
+                LineIndex found;
+                // The old line which starts where the last found line starts, once synchronized.
+                size_t synchronized = 0;
+
+                InputBuffer<T> buffer(std::ranges::subrange(input.begin() + from, input.end()));
+                size_t scanned = from;
+                while(synchronized == 0 && scanned < input.size()) {
+                    size_t count = found.line_count();
+                    size_t before = scanned;
+                    scan_lines(buffer.begin(), scanned, scanned, scanned + 1, buffer.end(), found);
+                    buffer.release(scanned - before);
+
+                    if(found.line_count() > count && scanned >= new_end) {
+                        size_t start = scanned - edit.inserted + edit.removed;
+                        size_t l = old.line(start);
+                        if(old.line_start(l) == start) {
+                            synchronized = l;
+                        }
+                    }
+                }
+
+                // The old lines replaced by the found ones.
+                size_t replaced = (synchronized != 0 ? synchronized : old.line_count()) - line;
+                if(edit.removed == edit.inserted && found.line_count() - 1 == replaced) {
+                    bool same = true;
+                    for(size_t i = 1; same && i <= replaced; ++i) {
+                        same = found.line_start(i + 1) == old.line_start(line + i);
+                    }
+                    if(same) {
+                        return std::nullopt;
+                    }
+                }
+
+                LineIndex lines = old.first_lines(line);
+                for(size_t i = 2; i <= found.line_count(); ++i) {
+                    lines.add_line(found.line_start(i));
+                }
+                if(synchronized != 0) {
+                    lines.add_lines(old, synchronized, static_cast<std::ptrdiff_t>(edit.inserted) - static_cast<std::ptrdiff_t>(edit.removed));
+                }
+                return lines;
+            }
+
+            // Lexes the input, which starts at `offset`, until it is exhausted or `stop(offset)` holds before some token.
+            // `reach` is that of the token before the input. The tokens refer to `lexed`, and the starts of the lines
+            // are added to `scan` unless it is null.
+            template<typename F>
+            void lex(InputBuffer<T>& input, size_t offset, size_t reach, std::shared_ptr<Input> const& lexed, LineIndex* scan, std::vector<Positioned<R>>& output, F&& stop) const {
+                auto cur = input.begin();
+                size_t scanned = offset;
 
                 std::vector<Rule<T, M, R>> const& rulz = rules();
-                M const& nl = newline();
-                std::vector current(rulz.size(), std::optional<size_t>());
+                std::vector current(rulz.size(), std::optional<Submatches>());
 
-                while(cur != input.end()) {
+                while(cur != input.end() && !stop(offset)) {
                     std::ranges::transform(
                         rulz,
                         current.begin(), 
-                        [this, &cur, &input](auto p){ return maximal(p.matcher(), cur, input.end()); }
+                        [this, &cur, &input](auto const& p){ return maximal(p.matcher(), cur, input.end()); }
                     );
 
                     auto r = std::max_element(
@@ -146,43 +519,238 @@ namespace tfl {
                                 return false;
                             }
                             else {
-                                return r.value() > l.value();
+                                return r->length > l->length;
                             }
                         }
                     );
 
-                    if(!r->has_value()) {
+                    if(!r->has_value() && !_error) {
                         throw LexingException("No rule applicable");
                     }
 
-                    auto p = rulz[std::distance(current.begin(), r)];
-                    auto l = r->value();
+                    auto l = r->has_value() ? r->value().length : unlexable(cur, input.end());
                     auto next = cur; 
                     std::advance(next, l);
-                    output.push_back( Positioned<R>(line, col, p.map(cur, next)) );
-
-                    col += l;
-                    auto nl_len = maximal(nl, cur, input.end());
-                    if(nl_len.has_value()) {
-                        col = 1;
-                        line += 1;
-                        l += nl_len.value();
+
+                    typename Rule<T, M, R>::Captures captures;
+                    if(r->has_value()) {
+                        for(auto const& group: r->value().groups) {
+                            if(group.has_value()) {
+                                auto beg = cur;
+                                std::advance(beg, group->position);
+                                auto end = beg;
+                                std::advance(end, group->length);
+                                captures.emplace_back(std::ranges::subrange(beg, end));
+                            }
+                            else {
+                                captures.emplace_back(std::nullopt);
+                            }
+                        }
                     }
+                    Positioned<R> token(
+                        Match{offset, l}, 
+                        lexed, 
+                        r->has_value() 
+                            ? rulz[std::distance(current.begin(), r)].map(cur, next, captures) 
+                            : _error(std::ranges::subrange(cur, next))
+                    );
 
+                    if(scan != nullptr) {
+                        scan_lines(cur, offset, scanned, offset + l, input.end(), *scan);
+                    }
+
+                    // The buffer holds every value read by the matchers; reaching the end also counts as a read.
+                    reach = std::max(reach, offset + input.buffed_size() + (input.consumed_all() ? 1 : 0));
+                    token._reach = reach;
+                    output.push_back(std::move(token));
+
+                    offset += l;
                     input.release(l);
                     cur = input.begin();
                 }
-                
+            }
+
+        public:
+
+            virtual std::shared_ptr<LexerBase<T, Positioned<R>>> recovering(std::function<R(Unlexable)> const& error) const final override {
+                auto lexer = copy();
+                lexer->_error = error;
+                lexer->_resync = combined();
+                return lexer;
+            }
+
+            virtual std::vector<Positioned<R>> apply(InputBuffer<T>& input) const final override {
+                std::vector<Positioned<R>> output;
+                auto lexed = std::make_shared<Input>();
+                lex(input, 0, 0, lexed, &lexed->lines, output, [](size_t){ return false; });
+                return output;
+            }
+
+            // The lines are indexed in a separate pass, rather than while lexing.
+            virtual std::vector<Positioned<R>> apply(std::span<T const> input) const final override {
+                std::vector<Positioned<R>> output;
+                auto lexed = std::make_shared<Input>();
+                InputBuffer<T> buffer(input);
+                lex(buffer, 0, 0, lexed, nullptr, output, [](size_t){ return false; });
+                index_lines(input, lexed->lines);
                 return output;
             }
+
+            // The tokens which read the edited values are relexed, until a token starts where an old token
+            // (located after the edit) started: the lexer is then in the same state, so the following tokens
+            // are kept, shifted by the edit. As the reaches of the tokens increase, the first relexed token is
+            // found by a binary search.
+            //
+            // The edit and the new line index (see reindex_lines()) are recorded in the input shared by the tokens,
+            // so that the kept tokens are shifted lazily. If the input is shared with other values (copies of the
+            // tokens for instance), the tokens refer to a new input instead, so that these values keep their positions.
+            virtual Edit relex(std::vector<Positioned<R>>& tokens, Edit const& edit, std::span<T const> input) const final override {
+                if(edit.position + edit.inserted > input.size()) {
+                    throw std::invalid_argument("The edit does not fit in the input.");
+                }
+
+                size_t old_end = edit.position + edit.removed;
+                auto shifted = [&edit](size_t offset){ return offset - edit.removed + edit.inserted; };
+
+                auto first = std::ranges::partition_point(tokens, [&edit](auto const& token){ return token.reach() <= edit.position; });
+                if(first == tokens.end() && !tokens.empty()) {
+                    first = std::prev(tokens.end());
+                }
+                size_t start = std::distance(tokens.begin(), first);
+                size_t offset = (first != tokens.end()) ? first->offset() : 0;
+                size_t reach = (start > 0) ? tokens[start - 1].reach() : 0;
+
+                std::shared_ptr<Input> old = tokens.empty() ? nullptr : tokens.front()._input;
+                std::optional<LineIndex> lines;
+                if(old) {
+                    lines = reindex_lines(old->lines, edit, input);
+                }
+                else {
+                    lines.emplace();
+                    index_lines(input, *lines);
+                }
+
+                bool moved = edit.removed != edit.inserted;
+                bool owned = old && static_cast<size_t>(old.use_count()) == tokens.size() + 1;
+                bool renewed = !old || (!owned && (moved || lines.has_value()));
+                std::shared_ptr<Input> lexed = old;
+                if(renewed) {
+                    lexed = std::make_shared<Input>();
+                    lexed->lines = lines.has_value() ? std::move(*lines) : old->lines;
+                }
+
+                // Index of the first old token which may be kept.
+                size_t kept = start;
+                bool synchronized = false;
+
+                std::vector<Positioned<R>> relexed;
+                InputBuffer<T> buffer(std::ranges::subrange(input.begin() + offset, input.end()));
+                lex(buffer, offset, reach, lexed, nullptr, relexed, [&](size_t offset) {
+                    while(kept < tokens.size() && (tokens[kept].offset() < old_end || shifted(tokens[kept].offset()) < offset)) {
+                        ++kept;
+                    }
+                    synchronized = kept < tokens.size() && shifted(tokens[kept].offset()) == offset;
+                    return synchronized;
+                });
+
+                if(!synchronized) {
+                    kept = tokens.size();
+                }
+
+                if(renewed) {
+                    auto renew = [&lexed](Positioned<R>& token, size_t offset, size_t reach) {
+                        token._offset = offset;
+                        token._reach = reach;
+                        token._epoch = 0;
+                        token._input = lexed;
+                    };
+                    for(auto it = tokens.begin(); it != tokens.begin() + start; ++it) {
+                        renew(*it, it->offset(), it->reach());
+                    }
+                    for(auto it = tokens.begin() + kept; it != tokens.end(); ++it) {
+                        renew(*it, shifted(it->offset()), shifted(it->reach()));
+                    }
+                }
+                else if(owned) {
+                    if(lines.has_value()) {
+                        old->lines = std::move(*lines);
+                    }
+                    if(moved) {
+                        old->edits.push_back(edit);
+                        for(auto& token: relexed) {
+                            token._epoch = old->current();
+                        }
+                    }
+                }
+
+                // The reaches of the kept tokens are raised to the last relexed one, up to the first one above it.
+                reach = relexed.empty() ? reach : relexed.back()._reach;
+                for(auto it = tokens.begin() + kept; it != tokens.end() && it->reach() < reach; ++it) {
+                    it->update();
+                    it->_reach = reach;
+                }
+
+                // The relexed tokens replace the old ones in place, so that the kept tokens are moved at most once.
+                size_t common = std::min(relexed.size(), kept - start);
+                std::move(relexed.begin(), relexed.begin() + common, tokens.begin() + start);
+                if(relexed.size() > common) {
+                    tokens.insert(tokens.begin() + kept, std::make_move_iterator(relexed.begin() + common), std::make_move_iterator(relexed.end()));
+                }
+                else {
+                    tokens.erase(tokens.begin() + start + common, tokens.begin() + kept);
+                }
+
+                // The edits are applied to the tokens of the first epoch (most of them) by merging their increasing
+                // offsets and reaches with the values from which each edit applies.
+                if(lexed->edits.size() > Input::MAX_EDITS) {
+                    auto offsets = lexed->thresholds(false);
+                    auto reaches = lexed->thresholds(true);
+                    auto next_offset = offsets.cbegin();
+                    auto next_reach = reaches.cbegin();
+                    std::ptrdiff_t offset_shift = 0;
+                    std::ptrdiff_t reach_shift = 0;
+                    for(auto& token: tokens) {
+                        if(token._epoch != lexed->epoch) {
+                            token.update();
+                            continue;
+                        }
+                        for(; next_offset != offsets.cend() && next_offset->first <= token._offset; ++next_offset) {
+                            offset_shift += next_offset->second;
+                        }
+                        for(; next_reach != reaches.cend() && next_reach->first <= token._reach; ++next_reach) {
+                            reach_shift += next_reach->second;
+                        }
+                        token._offset = static_cast<size_t>(static_cast<std::ptrdiff_t>(token._offset) + offset_shift);
+                        token._reach = static_cast<size_t>(static_cast<std::ptrdiff_t>(token._reach) + reach_shift);
+                        token._epoch = lexed->current();
+                    }
+                    lexed->epoch = lexed->current();
+                    lexed->edits.clear();
+                }
+
+                return Edit{start, kept - start, relexed.size()};
+            }
         };
         
         template<typename T, typename R>
         class SimpleDerivationLexer final : public SimpleLexerBase<T, Regex<T>, R> {
             std::vector<Rule<T, Regex<T>, R>> _rules;
             Regex<T> _nl;
+            NewlineStarts<T> _nl_starts;
 
         protected:
+            std::shared_ptr<SimpleLexerBase<T, Regex<T>, R>> copy() const override {
+                return std::make_shared<SimpleDerivationLexer>(*this);
+            }
+
+            std::vector<DFA<T>> combined() const override {
+                Regex<T> all = Regex<T>::empty();
+                for(auto const& rule: _rules) {
+                    all = all | rule.matcher();
+                }
+                return {make_dfa(all)};
+            }
+
             std::vector<Rule<T, Regex<T>, R>> const& rules() const override {
                 return _rules;
             }
@@ -191,15 +759,24 @@ namespace tfl {
                 return _nl;
             }
 
-            std::optional<typename std::vector<T>::difference_type> maximal(Regex<T> regex, InputBuffer<T>::Iterator beg, InputBuffer<T>::Sentinel end) const override {
-                std::optional<typename std::vector<T>::difference_type> max = std::nullopt;
-                typename std::vector<T>::difference_type idx = 0;
+            NewlineStarts<T> const& newline_starts() const override {
+                return _nl_starts;
+            }
+
+            std::optional<Submatches> maximal(Regex<T> const& matcher, InputBuffer<T>::Iterator beg, InputBuffer<T>::Sentinel end) const override {
+                std::optional<Submatches> max = std::nullopt;
+                Regex<T> regex = matcher;
+                std::size_t idx = 0;
                 for(; beg != end; ++beg) {
                     ++idx;
 
                     regex = derive(*beg, regex);
                     if(is_nullable(regex)) {
-                        max = idx;
+                        max = Submatches{idx, {}};
+                    }
+                    // No longer match can be found from a dead derivative.
+                    else if(has_empty_language(regex)) {
+                        break;
                     }
                 }
 
@@ -209,43 +786,122 @@ namespace tfl {
         public:
             template<input_range_of<Rule<T, Regex<T>, R>> Range>
             SimpleDerivationLexer(Range&& rules, Regex<T> newline = Regex<T>::empty()): 
-            _rules(std::ranges::cbegin(rules), std::ranges::cend(rules)), _nl(newline) {}
+            _rules(std::ranges::cbegin(rules), std::ranges::cend(rules)), _nl(newline), _nl_starts(tfl::newline_starts(make_dfa(newline))) {}
         };
 
-        template<typename T, typename R>
-        class SimpleDFALexer final : public SimpleLexerBase<T, DFA<T>, R> {
-            std::vector<Rule<T, DFA<T>, R>> _rules;
-            DFA<T> _nl;
+        template<typename T, typename R, typename A = DFA<T>>
+        class SimpleDFALexer final : public SimpleLexerBase<T, A, R> {
+            std::vector<Rule<T, A, R>> _rules;
+            A _nl;
+            NewlineStarts<T> _nl_starts;
+            // The union of the rules' regexes, if the lexer was built from them.
+            std::optional<Regex<T>> _all;
+            // The indices of the rules which were dropped, as no token could be produced by them.
+            std::vector<std::size_t> _pruned;
+
+            // Drops the rules whose nonempty matches are all matched by an earlier rule: as the earlier rule
+            // wins ties, they could never produce a token. Only the languages of DFAs can be compared.
+            void prune() {
+                if constexpr(std::same_as<A, DFA<T>>) {
+                    std::vector<Rule<T, A, R>> kept;
+                    std::vector<DFA<T> const*> earlier;
+                    kept.reserve(_rules.size());
+                    for(std::size_t i = 0; i < _rules.size(); ++i) {
+                        if(is_covered(_rules[i].matcher(), earlier, true)) {
+                            _pruned.push_back(i);
+                        }
+                        else {
+                            // No reallocation can invalidate the pointers, as enough space was reserved.
+                            kept.push_back(std::move(_rules[i]));
+                            earlier.push_back(&kept.back().matcher());
+                        }
+                    }
+                    _rules = std::move(kept);
+                }
+            }
 
         protected:
-            std::vector<Rule<T, DFA<T>, R>> const& rules() const override {
+            std::shared_ptr<SimpleLexerBase<T, A, R>> copy() const override {
+                return std::make_shared<SimpleDFALexer>(*this);
+            }
+
+            std::vector<DFA<T>> combined() const override {
+                if(_all.has_value()) {
+                    return {make_dfa(*_all)};
+                }
+                else if constexpr(std::same_as<A, DFA<T>>) {
+                    std::vector<DFA<T>> dfas;
+                    std::ranges::transform(_rules, std::back_inserter(dfas), [](auto const& rule){ return rule.matcher(); });
+                    return dfas;
+                }
+                else {
+                    return {};
+                }
+            }
+
+            std::vector<Rule<T, A, R>> const& rules() const override {
                 return _rules;
             }
 
-            DFA<T> const& newline() const override {
+            A const& newline() const override {
                 return _nl;
             }
 
-            std::optional<typename std::vector<T>::difference_type> maximal(DFA<T> dfa, InputBuffer<T>::Iterator beg, InputBuffer<T>::Sentinel end) const override {
-                auto res = dfa.munch(std::ranges::subrange(beg, end));
+            NewlineStarts<T> const& newline_starts() const override {
+                return _nl_starts;
+            }
+
+            std::optional<Submatches> maximal(A const& dfa, InputBuffer<T>::Iterator beg, InputBuffer<T>::Sentinel end) const override {
+                auto input = std::ranges::subrange(beg, end);
 
-                return res.has_value() && res.value() > 0
-                    ? std::optional<typename std::vector<T>::difference_type>{res.value()} 
-                    : std::optional<typename std::vector<T>::difference_type>{};
+                // Automata which extract submatches (see TaggedDFA) report them in the same pass.
+                if constexpr(requires { { dfa.munch_submatches(input) } -> std::same_as<std::optional<Submatches>>; }) {
+                    auto res = dfa.munch_submatches(input);
+                    return res.has_value() && res->length > 0 ? res : std::nullopt;
+                }
+                else {
+                    auto res = dfa.munch(input);
+                    return res.has_value() && res.value() > 0
+                        ? std::optional<Submatches>{Submatches{res.value(), {}}}
+                        : std::optional<Submatches>{};
+                }
             }
 
         public:
+            std::vector<std::size_t> pruned_rules() const override {
+                return _pruned;
+            }
+
             template<input_range_of<Rule<T, Regex<T>, R>> Range>
-            SimpleDFALexer(Range&& rules, Regex<T> newline = Regex<T>::empty()): 
+            SimpleDFALexer(
+                Range&& rules, 
+                Regex<T> newline = Regex<T>::empty(), 
+                std::function<A(Regex<T> const&)> builder = [](Regex<T> const& regex){ return make_dfa(regex); }
+            ): 
             _rules(), 
-            _nl{make_dfa(newline)} 
+            _nl{builder(newline)},
+            _nl_starts(tfl::newline_starts(make_dfa(newline)))
             {
+                _all = Regex<T>::empty();
                 for(auto& rule: rules) {
                     _rules.emplace_back(
-                        make_dfa(rule.matcher()),
+                        builder(rule.matcher()),
                         rule._map
                     );
+                    _all = *_all | rule.matcher();
+                }
+                prune();
+            }
+
+            template<input_range_of<Rule<T, A, R>> Range>
+            SimpleDFALexer(Range&& rules, A newline): 
+            _rules(std::ranges::cbegin(rules), std::ranges::cend(rules)), 
+            _nl(newline) 
+            {
+                if constexpr(std::same_as<A, DFA<T>>) {
+                    _nl_starts = tfl::newline_starts(newline);
                 }
+                prune();
             }
         };
 
@@ -259,7 +915,19 @@ namespace tfl {
             Map(Lexer<T, U> const& underlying, F&& map): _map(std::forward<F>(map)), _underlying(underlying) {}
 
             virtual std::vector<R> apply(InputBuffer<T>& in) const {
-                std::vector<U> sub(_underlying(in));
+                return map(_underlying(in));
+            }
+
+            virtual std::vector<R> apply(std::span<T const> in) const {
+                return map(_underlying(in));
+            }
+
+            virtual std::vector<std::size_t> pruned_rules() const {
+                return _underlying.pruned_rules();
+            }
+
+        private:
+            std::vector<R> map(std::vector<U> const& sub) const {
                 std::vector<R> res(sub.size());
                 std::transform(sub.cbegin(), sub.cend(), res.begin(), _map);
                 return res;
@@ -281,6 +949,10 @@ namespace tfl {
                 sub.erase(end, sub.cend());
                 return sub;
             }
+
+            virtual std::vector<std::size_t> pruned_rules() const {
+                return _underlying.pruned_rules();
+            }
         };
     };
 
@@ -293,6 +965,9 @@ namespace tfl {
      * - A map function of type \f$ \textit{Match} \longmapsto R \f$ which is 
      * applied to the matched sequence.
      *
+     * The map may also take the subsequences captured by the groups of the regex
+     * (see \ref Regex::capture()), which are only reported by lexers built with \ref Lexer::make_tagged_dfa_lexer().
+     *
      * @tparam T The alphabet type.
      * @tparam M The matcher type.
      * @tparam R The result type.
@@ -302,20 +977,22 @@ namespace tfl {
     public:
         using MatchIt = InputBuffer<T>::Iterator;
         using Match = std::ranges::subrange<MatchIt>;
-        using Map = std::function<R(Match)>;
+        using Captures = std::vector<std::optional<Match>>;
+        using Map = std::function<R(Match, Captures const&)>;
 
     private:
         template<typename, typename, typename> friend class SimpleLexerBase;
-        template<typename, typename> friend class SimpleDFALexer;
+        template<typename, typename> friend class SimpleDerivationLexer;
+        template<typename, typename, typename> friend class SimpleDFALexer;
 
         M _matcher;
         Map _map;
 
-        R map(MatchIt beg, MatchIt end) const {
-            return _map(std::ranges::subrange(beg, end));
+        R map(MatchIt beg, MatchIt end, Captures const& captures) const {
+            return _map(std::ranges::subrange(beg, end), captures);
         }
 
-        M matcher() const {
+        M const& matcher() const {
             return _matcher;
         }
 
@@ -326,6 +1003,17 @@ namespace tfl {
          * @param map The map.
          */
         template<std::invocable<Match> F>
+        Rule(M const& matcher, F&& map): 
+        _matcher(matcher), 
+        _map([map = std::decay_t<F>(std::forward<F>(map))](Match match, Captures const&) mutable { return map(match); }) 
+        {}
+
+        /**
+         * @tparam F The map type, which also takes the captured subsequences (one per group, empty if the group did not participate).
+         * @param matcher The matcher.
+         * @param map The map.
+         */
+        template<typename F> requires std::invocable<F, Match, Captures const&> && (!std::invocable<F, Match>)
         Rule(M const& matcher, F&& map): _matcher(matcher), _map(std::forward<F>(map)) {}
     };
 
@@ -354,6 +1042,7 @@ namespace tfl {
         std::shared_ptr<LexerBase<T, R>> _lexer;
 
         Lexer(LexerBase<T, R>* ptr): _lexer(ptr) {}
+        Lexer(std::shared_ptr<LexerBase<T, R>> ptr): _lexer(std::move(ptr)) {}
 
     public:
 
@@ -374,6 +1063,7 @@ namespace tfl {
          * @brief Generates a lexer where \ref DFA are used for language-membership testing.
          *
          * This lexer is way faster, but requires some time to build the DFAs.
+         * The rules shadowed by earlier rules are dropped (see \ref pruned_rules()).
          * 
          * @param rules Rules specifying the lexer.
          * @param newline Regex defining a newline.
@@ -383,6 +1073,88 @@ namespace tfl {
             return Lexer<T, Positioned<R>>(new SimpleDFALexer<T, R>(std::forward<Range>(rules), newline));
         }
 
+        /**
+         * @brief Generates a lexer where \ref TaggedDFA are used for language-membership testing.
+         *
+         * This lexer behaves like the one built by \ref make_dfa_lexer(), but the subsequences captured
+         * by the groups of the rules (see \ref Regex::capture()) are passed to their maps, without scanning the tokens again.
+         * 
+         * @param rules Rules specifying the lexer.
+         * @param newline Regex defining a newline.
+         * @exception std::invalid_argument If a capture appears within a complement or a conjunction.
+         */
+        template<input_range_of<Rule<T, Regex<T>, R>> Range>
+        static Lexer<T, Positioned<R>> make_tagged_dfa_lexer(Range rules, Regex<T> newline = Regex<T>::empty()) {
+            return Lexer<T, Positioned<R>>(new SimpleDFALexer<T, R, TaggedDFA<T>>(
+                std::forward<Range>(rules), 
+                newline, 
+                [](Regex<T> const& regex){ return make_tagged_dfa(regex); }
+            ));
+        }
+
+        /**
+         * @brief Generates a lexer from already built \ref DFA.
+         *
+         * This lexer behaves like the one built by \ref make_dfa_lexer(), but does not have to build
+         * its DFAs (which can for instance be deserialized, see \ref deserialize()).
+         * The rules shadowed by earlier rules are dropped as well (see \ref pruned_rules()).
+         * 
+         * @param rules Rules specifying the lexer.
+         * @param newline DFA defining a newline.
+         */
+        template<input_range_of<Rule<T, DFA<T>, R>> Range>
+        static Lexer<T, Positioned<R>> make_dfa_lexer(Range rules, DFA<T> newline = make_dfa(Regex<T>::empty())) {
+            return Lexer<T, Positioned<R>>(new SimpleDFALexer<T, R>(std::forward<Range>(rules), newline));
+        }
+
+        /**
+         * @brief Generates a lexer where \ref DFA are used for language-membership testing, using a cache.
+         *
+         * Behaves like \ref make_dfa_lexer(), but the DFAs are obtained from (and added to) the cache,
+         * so that they are only built once.
+         * 
+         * @param rules Rules specifying the lexer.
+         * @param newline Regex defining a newline.
+         * @param cache The DFA cache.
+         */
+        template<input_range_of<Rule<T, Regex<T>, R>> Range, serializable_literal U = T>
+        static Lexer<T, Positioned<R>> make_dfa_lexer(Range rules, Regex<T> newline, DFACache<U>& cache) {
+            return Lexer<T, Positioned<R>>(new SimpleDFALexer<T, R>(
+                std::forward<Range>(rules), 
+                newline, 
+                [&cache](Regex<T> const& regex){ return make_dfa(regex, cache); }
+            ));
+        }
+
+        /**
+         * @brief Generates a lexer from automata behaving like \ref DFA.
+         *
+         * This allows using serialized DFAs (see \ref DFAView), which are used in place, 
+         * or generated automata (see \ref cpp_source()).
+         * 
+         * @tparam A The automaton type.
+         * @param rules Rules specifying the lexer.
+         * @param newline Automaton defining a newline.
+         */
+        template<prefix_automaton<T> A, input_range_of<Rule<T, A, R>> Range>
+        static Lexer<T, Positioned<R>> make_dfa_lexer(Range rules, A newline) {
+            return Lexer<T, Positioned<R>>(new SimpleDFALexer<T, R, A>(std::forward<Range>(rules), newline));
+        }
+
+        /**
+         * @brief Generates a lexer from \ref StaticDFA.
+         *
+         * The automata are used in place, through their views (see \ref StaticDFAView), so that no table 
+         * is built when the lexer is. Rules can be given the static automata directly, which are converted into views.
+         * 
+         * @param rules Rules specifying the lexer.
+         * @param newline Automaton defining a newline (none by default).
+         */
+        template<input_range_of<Rule<T, StaticDFAView<T>, R>> Range>
+        static Lexer<T, Positioned<R>> make_dfa_lexer(Range rules, StaticDFAView<T> newline = StaticDFAView<T>()) {
+            return Lexer<T, Positioned<R>>(new SimpleDFALexer<T, R, StaticDFAView<T>>(std::forward<Range>(rules), newline));
+        }
+
         /**
          * @brief Generates a lexer where \ref derive(Regex) is used for language-membership testing.
          */
@@ -397,6 +1169,43 @@ namespace tfl {
             return make_dfa_lexer(std::ranges::views::all(rules), newline);
         }
 
+        /**
+         * @brief Generates a lexer where \ref TaggedDFA are used for language-membership testing.
+         */
+        static Lexer<T, Positioned<R>> make_tagged_dfa_lexer(std::initializer_list<Rule<T, Regex<T>, R>> rules, Regex<T> newline = Regex<T>::empty()) {
+            return make_tagged_dfa_lexer(std::ranges::views::all(rules), newline);
+        }
+
+        /**
+         * @brief Generates a lexer from already built \ref DFA.
+         */
+        static Lexer<T, Positioned<R>> make_dfa_lexer(std::initializer_list<Rule<T, DFA<T>, R>> rules, DFA<T> newline = make_dfa(Regex<T>::empty())) {
+            return make_dfa_lexer(std::ranges::views::all(rules), newline);
+        }
+
+        /**
+         * @brief Generates a lexer where \ref DFA are used for language-membership testing, using a cache.
+         */
+        template<serializable_literal U = T>
+        static Lexer<T, Positioned<R>> make_dfa_lexer(std::initializer_list<Rule<T, Regex<T>, R>> rules, Regex<T> newline, DFACache<U>& cache) {
+            return make_dfa_lexer(std::ranges::views::all(rules), newline, cache);
+        }
+
+        /**
+         * @brief Generates a lexer from automata behaving like \ref DFA.
+         */
+        template<prefix_automaton<T> A>
+        static Lexer<T, Positioned<R>> make_dfa_lexer(std::initializer_list<Rule<T, A, R>> rules, A newline) {
+            return make_dfa_lexer(std::ranges::views::all(rules), newline);
+        }
+
+        /**
+         * @brief Generates a lexer from \ref StaticDFA.
+         */
+        static Lexer<T, Positioned<R>> make_dfa_lexer(std::initializer_list<Rule<T, StaticDFAView<T>, R>> rules, StaticDFAView<T> newline = StaticDFAView<T>()) {
+            return make_dfa_lexer(std::ranges::views::all(rules), newline);
+        }
+
         /**
          * @brief Generates a lexer where \ref DFA are used for language-membership testing.
          * @see \ref make_dfa_lexer()
@@ -426,8 +1235,66 @@ namespace tfl {
          */
         template<input_range_of<Rule<T, Regex<T>, R>> Range>
         std::vector<R> operator()(Range&& range) const {
-            InputBuffer<T> input(std::forward<Range>(range));
-            return _lexer->apply(input);
+            if constexpr(std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range> && std::same_as<std::ranges::range_value_t<Range>, T>) {
+                return _lexer->apply(std::span<T const>(std::ranges::data(range), std::ranges::size(range)));
+            }
+            else {
+                InputBuffer<T> input(std::forward<Range>(range));
+                return _lexer->apply(input);
+            }
+        }
+
+        /**
+         * @brief Updates the tokens of an input after it was edited, only relexing the tokens affected by the edit.
+         *
+         * The lexer starts from the first token whose lexing read an edited value, and stops as soon as a token
+         * starts where an unedited token used to start. The following tokens are kept, and their positions are shifted.
+         * Likewise, the newlines are only searched around the edit. Hence, the cost of a small edit does not depend
+         * on the size of the input.
+         *
+         * The kept tokens are shifted lazily, unless the \ref LineIndex of the input is shared with other values (copies
+         * of the tokens, for instance): the tokens then refer to a new index, so that these values keep their positions.
+         *
+         * The updated tokens are the same as the ones obtained by lexing the whole edited input.
+         *
+         * @param tokens The tokens produced by this lexer from the input before the edit, updated in place.
+         * @param edit The edit.
+         * @param input The whole input, after the edit.
+         * @return The corresponding edit of the tokens (which can be passed to \ref IncrementalParser::reparse()).
+         * @exception LexingException If the lexer was mapped or filtered (see \ref map(), \ref filter()),
+         * or if no rule is applicable to the edited input.
+         */
+        template<std::ranges::contiguous_range Range> requires std::same_as<std::ranges::range_value_t<Range>, T>
+        Edit relex(std::vector<R>& tokens, Edit const& edit, Range const& input) const {
+            return _lexer->relex(tokens, edit, std::span<T const>(std::ranges::data(input), std::ranges::size(input)));
+        }
+
+        /**
+         * @brief Returns a lexer which does not stop at unlexable values, but turns them into error tokens.
+         *
+         * When no rule applies, the values up to the next position where some rule applies are mapped to a token
+         * (which is positioned like the others). This position is found in a single pass, by running the rules'
+         * combined automaton from every position at once, rather than by trying each rule at each position.
+         * The rules are tried one by one for lexers built from other automata than \ref DFA.
+         *
+         * @param error Maps the unlexable values to a token.
+         * @exception LexingException If the lexer was mapped or filtered (see \ref map(), \ref filter()).
+         */
+        template<std::invocable<std::ranges::subrange<typename InputBuffer<T>::Iterator>> F>
+        Lexer<T, R> recovering(F&& error) const {
+            return Lexer<T, R>(_lexer->recovering(std::forward<F>(error)));
+        }
+
+        /**
+         * @brief Returns the indices of the rules which were dropped when the lexer was built, in increasing order.
+         *
+         * The lexers built from \ref DFA (see \ref make_dfa_lexer()) drop the rules which are shadowed by earlier rules,
+         * i.e. whose nonempty matches are all matched by earlier rules (which win ties), so that they are not run while lexing.
+         * This is checked with \ref is_subset() on the union of the earlier rules. Such rules usually denote a mistake
+         * in the ordering of the rules (a keyword after the identifiers, for instance).
+         */
+        std::vector<std::size_t> pruned_rules() const {
+            return _lexer->pruned_rules();
         }
 
         /**
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Contains the definition of the \ref LineIndex
+ * @file
+ */
+
+namespace tfl {
+
+    /**
+     * @brief The offsets at which the lines of some input start.
+     *
+     * Lines and columns are not tracked while lexing: they are computed on demand from the offset of a value,
+     * using a binary search among the line starts.
+     */
+    class LineIndex final {
+        std::vector<std::size_t> _starts{0};
+
+    public:
+        /**
+         * @brief Indexes the lines of a byte sequence, in which each byte of a set ends a line.
+         *
+         * The newlines are found in a single pass, using the vectorized \ref ByteSet::find().
+         *
+         * @param input The byte sequence.
+         * @param newlines The bytes ending a line.
+         */
+        template<byte_like T>
+        static LineIndex of(std::span<T const> input, ByteSet const& newlines) {
+            LineIndex index;
+            T const* end = input.data() + input.size();
+            for(T const* it = newlines.find(input.data(), end); it != end; it = newlines.find(it + 1, end)) {
+                index.add_line(static_cast<std::size_t>(it - input.data()) + 1);
+            }
+            return index;
+        }
+
+        /**
+         * @brief Returns an index made of the first lines of this one.
+         *
+         * @param lines The number of lines kept, from 1 to \ref line_count().
+         */
+        LineIndex first_lines(std::size_t lines) const {
+            LineIndex index;
+            index._starts.assign(_starts.cbegin(), _starts.cbegin() + lines);
+            return index;
+        }
+
+        /**
+         * @brief Adds the lines of another index which follow one of its lines, shifted by some offset.
+         *
+         * @param other The other index.
+         * @param line The line of `other` after which the lines are added.
+         * @param shift The offset added to their starts, which must still be greater than the previous line starts.
+         */
+        void add_lines(LineIndex const& other, std::size_t line, std::ptrdiff_t shift) {
+            _starts.reserve(_starts.size() + other._starts.size() - line);
+            for(auto it = other._starts.cbegin() + line; it != other._starts.cend(); ++it) {
+                _starts.push_back(static_cast<std::size_t>(static_cast<std::ptrdiff_t>(*it) + shift));
+            }
+        }
+
+        /**
+         * @brief Adds the start of a new line.
+         *
+         * @param start The offset of the line start. Must be greater than the previous line starts.
+         */
+        void add_line(std::size_t start) {
+            _starts.push_back(start);
+        }
+
+        /**
+         * @brief Returns the number of lines.
+         */
+        std::size_t line_count() const {
+            return _starts.size();
+        }
+
+        /**
+         * @brief Returns the offset at which a line starts.
+         *
+         * @param line The line (starting from 1).
+         */
+        std::size_t line_start(std::size_t line) const {
+            return _starts[line - 1];
+        }
+
+        /**
+         * @brief Returns the line (starting from 1) containing an offset.
+         */
+        std::size_t line(std::size_t offset) const {
+            return std::distance(_starts.cbegin(), std::ranges::upper_bound(_starts, offset));
+        }
+
+        /**
+         * @brief Returns the line and the column (both starting from 1) of an offset.
+         */
+        std::pair<std::size_t, std::size_t> position(std::size_t offset) const {
+            std::size_t l = line(offset);
+            return {l, offset - _starts[l - 1] + 1};
+        }
+    };
+}
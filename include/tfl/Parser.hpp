@@ -2,14 +2,21 @@
 
 #include <vector>
 #include <memory>
+#include <any>
+#include <algorithm>
+#include <unordered_map>
 #include <functional>
 #include <type_traits>
 #include <optional>
 #include <variant>
 #include <tuple>
 #include <concepts>
+#include <ranges>
+#include <stdexcept>
+#include <string>
 
 #include "Concepts.hpp"
+#include "Edit.hpp"
 
 namespace tfl {
 
@@ -20,12 +27,16 @@ namespace tfl {
 
     template<typename, typename> class Parser;
     template<typename, typename> class Recursive;
+    template<typename, typename> class IncrementalParser;
+    class StaticParserImpl;
     
     class ParserImpl {
         ParserImpl() = delete;
 
         template<typename, typename> friend class Parser;
         template<typename, typename> friend class Recursive;
+        template<typename, typename> friend class IncrementalParser;
+        friend class StaticParserImpl;
 
         template<typename T, typename R>
         class ParserBase {
@@ -40,6 +51,112 @@ namespace tfl {
             virtual std::vector<std::pair<R, It>> apply(It const& beg, It const& end) const = 0;
         };
 
+        // Packrat memo table: the results of each parser at each position, and the extent of the input
+        // they depend on. While it is active, every type-erased parser goes through it.
+        template<typename T>
+        class Memo final {
+            using It = typename std::vector<T>::const_iterator;
+
+            struct Entry {
+                // The results, with the number of values they span (so that they can be moved by edits).
+                std::any results;
+                // One past the last position read to compute the results.
+                std::size_t extent;
+            };
+
+            struct Key {
+                void const* parser;
+                std::size_t position;
+
+                bool operator==(Key const&) const = default;
+            };
+
+            struct KeyHash {
+                std::size_t operator()(Key const& key) const {
+                    return std::hash<void const*>{}(key.parser) ^ (std::hash<std::size_t>{}(key.position) * 31);
+                }
+            };
+
+            std::unordered_map<Key, Entry, KeyHash> _entries;
+            It _begin;
+            std::size_t _extent = 0;
+
+        public:
+            static inline thread_local Memo* active = nullptr;
+
+            // Activates the memo table for a parse of the input starting at `begin`.
+            class Activation final {
+                Memo* _previous;
+
+            public:
+                Activation(Memo& memo, It const& begin): _previous(active) {
+                    memo._begin = begin;
+                    active = &memo;
+                }
+                Activation(Activation const&) = delete;
+                ~Activation() {
+                    active = _previous;
+                }
+            };
+
+            std::size_t size() const {
+                return _entries.size();
+            }
+
+            void clear() {
+                _entries.clear();
+            }
+
+            void read(It const& it) {
+                _extent = std::max<std::size_t>(_extent, (it - _begin) + 1);
+            }
+
+            template<typename R>
+            std::vector<std::pair<R, It>> apply(ParserBase<T, R> const& parser, It const& beg, It const& end) {
+                using Stored = std::vector<std::pair<R, std::size_t>>;
+                std::size_t position = beg - _begin;
+                Key key{&parser, position};
+
+                if(auto it = _entries.find(key); it != _entries.end()) {
+                    _extent = std::max(_extent, it->second.extent);
+                    std::vector<std::pair<R, It>> res;
+                    for(auto const& [value, length]: std::any_cast<Stored const&>(it->second.results)) {
+                        res.emplace_back(value, beg + length);
+                    }
+                    return res;
+                }
+
+                std::size_t outer = _extent;
+                _extent = position;
+                auto res = parser.apply(beg, end);
+
+                Stored stored;
+                for(auto const& [value, next]: res) {
+                    stored.emplace_back(value, next - beg);
+                }
+                _entries.insert_or_assign(key, Entry{std::move(stored), _extent});
+                _extent = std::max(outer, _extent);
+                return res;
+            }
+
+            // Drops the entries which depend on the edited positions, and shifts the ones after them.
+            void edit(Edit const& edit) {
+                std::size_t old_end = edit.position + edit.removed;
+
+                std::unordered_map<Key, Entry, KeyHash> entries;
+                for(auto& [key, entry]: _entries) {
+                    if(entry.extent <= edit.position) {
+                        entries.emplace(key, std::move(entry));
+                    }
+                    else if(key.position >= old_end) {
+                        entry.extent = entry.extent - edit.removed + edit.inserted;
+                        entries.emplace(Key{key.parser, key.position - edit.removed + edit.inserted}, std::move(entry));
+                    }
+                }
+                _entries = std::move(entries);
+            }
+        };
+
         template<typename T>
         class Elem final: public ParserBase<T, T> {
             std::function<bool(T const&)> const _pred;
@@ -52,6 +169,9 @@ namespace tfl {
             Elem(F&& predicate): _pred(predicate) {}
 
             virtual Result apply(It const& beg, It const& end) const {
+                if(auto* memo = Memo<T>::active) {
+                    memo->read(beg);
+                }
                 return (beg != end && _pred(*beg)) ? Result{{*beg, beg+1}} : Result{};
             }
         };
@@ -174,6 +294,7 @@ namespace tfl {
     class Parser final {
         template<typename, typename> friend class Parser;
         template<typename, typename> friend class Recursive;
+        friend class StaticParserImpl;
 
         using Result = typename ParserImpl::ParserBase<T, R>::Result;
         using It = typename ParserImpl::ParserBase<T, R>::It;
@@ -188,6 +309,9 @@ namespace tfl {
         using ValueType = R;
 
         Result apply(It const& beg, It const& end) const {
+            if(auto* memo = ParserImpl::Memo<T>::active) {
+                return memo->apply(*_parser, beg, end);
+            }
             return _parser->apply(beg, end);
         }
 
@@ -308,6 +432,84 @@ namespace tfl {
         }
     };
 
+    /**
+     * @brief A parser which keeps its packrat memo table between parses.
+     *
+     * The results of every parser at every position are memoized, along with the extent of the input they depend on.
+     * When the input is edited, only the results depending on the edited values are dropped, and the ones after the edit
+     * are moved: reparsing after a small edit reuses the results of the unaffected subparsers.
+     *
+     * The maps of the parser are expected to be pure, since their results are reused.
+     *
+     * @tparam T The token type.
+     * @tparam R The result type.
+     */
+    template<typename T, typename R>
+    class IncrementalParser final {
+        Parser<T, R> _parser;
+        std::vector<T> _input;
+        ParserImpl::Memo<T> _memo;
+
+        R parse() {
+            typename ParserImpl::Memo<T>::Activation activation(_memo, _input.cbegin());
+            auto results = _parser.apply(_input.cbegin(), _input.cend());
+
+            std::vector<R> res;
+            for(auto& r: results) {
+                if(r.second == _input.cend()) {
+                    res.push_back(r.first);
+                }
+            }
+
+            if(res.size() != 1) {
+                throw ParsingException("Parsing failed: " + std::to_string(res.size()) + " match(es).");
+            }
+            return res[0];
+        }
+
+    public:
+        explicit IncrementalParser(Parser<T, R> const& parser): _parser(parser) {}
+
+        /**
+         * @brief Parses an input from scratch.
+         * @exception ParsingException If there is not exactly one way to parse the input.
+         */
+        template<std::ranges::input_range Range>
+        R parse(Range&& input) {
+            _input.assign(std::ranges::begin(input), std::ranges::end(input));
+            _memo.clear();
+            return parse();
+        }
+
+        /**
+         * @brief Parses the input after an edit, reusing the results which do not depend on the edited values.
+         *
+         * @param edit The edit of the previously parsed input (e.g. as returned by \ref Lexer::relex()).
+         * @param input The whole input, after the edit.
+         * @exception std::invalid_argument If the edit does not match the sizes of the inputs.
+         * @exception ParsingException If there is not exactly one way to parse the input.
+         */
+        template<std::ranges::input_range Range>
+        R reparse(Edit const& edit, Range&& input) {
+            std::size_t old_size = _input.size();
+            _input.assign(std::ranges::begin(input), std::ranges::end(input));
+            if(edit.position + edit.removed > old_size || old_size - edit.removed + edit.inserted != _input.size()) {
+                _memo.clear();
+                throw std::invalid_argument("The edit does not match the inputs.");
+            }
+
+            _memo.edit(edit);
+            return parse();
+        }
+
+        /**
+         * @brief Returns the number of memoized results.
+         */
+        std::size_t memo_size() const {
+            return _memo.size();
+        }
+    };
+
     template<typename T>
     struct Parsers {
     private:
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 #include <variant>
 #include <iterator>
@@ -36,6 +41,9 @@ namespace tfl {
      * - *Complement(Regex)*: \f$ \neg \f$ \ref operator~();
      * - *Conjunction(Regex, Regex)*: \f$ \mathbin{\&} \f$ \ref operator&().
      *
+     * Additionally, *Capture(group, Regex)* (\ref capture()) marks a subsequence to extract, without changing the language,
+     * and *Repetition(Regex, min, max)* (\ref repeat()) is a bounded repetition, \f$ r^{\{n,m\}} \f$, which is not unrolled.
+     *
      * This class is implemented in a <a href="https://en.wikipedia.org/wiki/Algebraic_data_type">ADT</a>-like fashion. 
      * Pattern matching can be performed using \ref matchers::Base in conjunction with \ref Regex::match().
      *
@@ -58,25 +66,69 @@ namespace tfl {
      */
     template<typename T>
     class Regex final {
+        // Structural properties, computed once when a node is built.
+        struct Metadata {
+            bool nullable;
+            std::size_t size;
+            std::size_t depth;
+            // Bloom filter of the literals (see literal_bit()).
+            std::uint64_t literals;
+            // Whether the regex contains a Σ or a complement, which may match other values than its literals.
+            bool open;
+            // Hash of the structure, from the kind of the node and the hashes of its subexpressions.
+            std::size_t hash;
+
+            static std::size_t combine(std::size_t seed, std::size_t value) {
+                return seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2));
+            }
+
+            static Metadata node(std::size_t kind, Metadata const& underlying, bool nullable, bool open) {
+                return {nullable, underlying.size + 1, underlying.depth + 1, underlying.literals, open, combine(kind, underlying.hash)};
+            }
+
+            static Metadata node(std::size_t kind, Metadata const& left, Metadata const& right, bool nullable) {
+                return {
+                    nullable, 
+                    left.size + right.size + 1, 
+                    std::max(left.depth, right.depth) + 1, 
+                    left.literals | right.literals, 
+                    left.open || right.open,
+                    combine(combine(kind, left.hash), right.hash)
+                };
+            }
+        };
+
+        static std::uint64_t literal_bit(T const& x) {
+            return std::uint64_t{1} << (std::hash<T>{}(x) % 64);
+        }
+
         struct Empty {
             template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.empty(); }
             template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.empty(); }
+            bool operator==(Empty const&) const = default;
+            Metadata metadata() const { return {false, 1, 1, 0, false, 0}; }
         };
 
         struct Epsilon {
             template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.epsilon(); }
             template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.epsilon(); }
+            bool operator==(Epsilon const&) const = default;
+            Metadata metadata() const { return {true, 1, 1, 0, false, 1}; }
         };
 
         struct Alphabet {
             template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.alphabet(); }
             template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.alphabet(); }
+            bool operator==(Alphabet const&) const = default;
+            Metadata metadata() const { return {false, 1, 1, 0, true, 2}; }
         };
 
         struct Literal {
             T const _lit;
             template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.literal(_lit); }
             template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.literal(_lit); }
+            bool operator==(Literal const&) const = default;
+            Metadata metadata() const { return {false, 1, 1, literal_bit(_lit), false, Metadata::combine(3, std::hash<T>{}(_lit))}; }
         };
 
         struct Disjunction {
@@ -84,6 +136,8 @@ namespace tfl {
             Regex const _right;
             template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.disjunction(_left, _right); }
             template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.disjunction(_left, _right); }
+            bool operator==(Disjunction const&) const = default;
+            Metadata metadata() const { return Metadata::node(4, _left.meta(), _right.meta(), _left.meta().nullable || _right.meta().nullable); }
         };
 
         struct Sequence {
@@ -91,18 +145,24 @@ namespace tfl {
             Regex const _right;
             template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.sequence(_left, _right); }
             template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.sequence(_left, _right); }
+            bool operator==(Sequence const&) const = default;
+            Metadata metadata() const { return Metadata::node(5, _left.meta(), _right.meta(), _left.meta().nullable && _right.meta().nullable); }
         };
 
         struct KleeneStar {
             Regex const _underlying;
             template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.kleene_star(_underlying); }
             template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.kleene_star(_underlying); }
+            bool operator==(KleeneStar const&) const = default;
+            Metadata metadata() const { return Metadata::node(6, _underlying.meta(), true, _underlying.meta().open); }
         };
 
         struct Complement {
             Regex const _underlying;
             template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.complement(_underlying); }
             template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.complement(_underlying); }
+            bool operator==(Complement const&) const = default;
+            Metadata metadata() const { return Metadata::node(7, _underlying.meta(), !_underlying.meta().nullable, true); }
         };
 
         struct Conjunction {
@@ -110,13 +170,60 @@ namespace tfl {
             Regex const _right;
             template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.conjunction(_left, _right); }
             template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.conjunction(_left, _right); }
+            bool operator==(Conjunction const&) const = default;
+            Metadata metadata() const { return Metadata::node(8, _left.meta(), _right.meta(), _left.meta().nullable && _right.meta().nullable); }
         };
 
-        using Variant = std::variant<Empty, Epsilon, Alphabet, Literal, Disjunction, Sequence, KleeneStar, Complement, Conjunction>;
-        std::shared_ptr<Variant> _regex;
+        struct Repetition {
+            Regex const _underlying;
+            std::size_t const _min;
+            std::size_t const _max;
+            template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.repetition(_underlying, _min, _max); }
+            template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.repetition(_underlying, _min, _max); }
+            bool operator==(Repetition const&) const = default;
+            Metadata metadata() const { 
+                Metadata meta = Metadata::node(9, _underlying.meta(), _min == 0 || _underlying.meta().nullable, _underlying.meta().open);
+                meta.hash = Metadata::combine(Metadata::combine(meta.hash, _min), _max);
+                return meta;
+            }
+        };
 
-        template<typename R> requires is_among_v<R, Empty, Epsilon, Alphabet, Literal, Disjunction, Sequence, KleeneStar, Complement, Conjunction>
-        Regex(R&& regex): _regex(std::make_shared<Variant>(std::forward<R>(regex))) {}
+        struct Capture {
+            std::size_t const _group;
+            Regex const _underlying;
+            template<typename R> inline R match(matchers::Base<T, R> const& matcher) const { return matcher.capture(_group, _underlying); }
+            template<typename R> inline R match(matchers::MutableBase<T, R>& matcher) const { return matcher.capture(_group, _underlying); }
+            bool operator==(Capture const&) const = default;
+            Metadata metadata() const { return _underlying.meta(); }
+        };
+
+        using Variant = std::variant<Empty, Epsilon, Alphabet, Literal, Disjunction, Sequence, KleeneStar, Complement, Conjunction, Repetition, Capture>;
+
+        struct Node {
+            Variant variant;
+            Metadata meta;
+        };
+        std::shared_ptr<Node const> _regex;
+
+        template<typename R> requires is_among_v<R, Empty, Epsilon, Alphabet, Literal, Disjunction, Sequence, KleeneStar, Complement, Conjunction, Repetition, Capture>
+        Regex(R&& regex) {
+            Metadata meta = regex.metadata();
+            _regex = std::make_shared<Node const>(Node{Variant(std::forward<R>(regex)), meta});
+        }
+
+        Metadata const& meta() const {
+            return _regex->meta;
+        }
+
+        template<typename R>
+        bool is() const {
+            return std::holds_alternative<R>(_regex->variant);
+        }
+
+        bool is_any() const {
+            return (is<Complement>() && std::get<Complement>(_regex->variant)._underlying.template is<Empty>())
+                || (is<KleeneStar>() && std::get<KleeneStar>(_regex->variant)._underlying.template is<Alphabet>());
+        }
 
     public:
         /**
@@ -124,6 +231,42 @@ namespace tfl {
         */
         using TokenType = T;
 
+        Regex(Regex const&) = default;
+        Regex(Regex&&) noexcept = default;
+        Regex& operator=(Regex const&) = default;
+        Regex& operator=(Regex&&) noexcept = default;
+
+        /**
+         * @brief Releases the nodes which are not shared with other regexes.
+         *
+         * The nodes of a deep regex are released from a worklist rather than recursively, 
+         * so that destroying it doesn't overflow the stack.
+         */
+        ~Regex() {
+            // Below this depth, the nodes are released recursively.
+            constexpr std::size_t max_recursion = 256;
+            if(_regex.use_count() != 1 || meta().depth <= max_recursion) {
+                return;
+            }
+
+            // The worklist of the outermost destructor running on this thread, if any.
+            thread_local std::vector<std::shared_ptr<Node const>>* pending = nullptr;
+            if(pending) {
+                pending->push_back(std::move(_regex));
+                return;
+            }
+
+            std::vector<std::shared_ptr<Node const>> worklist;
+            worklist.push_back(std::move(_regex));
+            pending = &worklist;
+            while(!worklist.empty()) {
+                // Releasing a node adds its unshared deep subexpressions to the worklist.
+                auto node = std::move(worklist.back());
+                worklist.pop_back();
+            }
+            pending = nullptr;
+        }
+
         
         /**
          * @name Constructors
@@ -171,10 +314,10 @@ namespace tfl {
          * - \f$ r \mathbin{|} \Sigma^{*} \equiv \Sigma^{*} \f$
          */
         Regex operator|(Regex const& that) const {
-            if(is_empty(*this) || is_any(that)) {
+            if(is<Empty>() || that.is_any()) {
                 return that;
             }
-            else if(is_empty(that) || is_any(*this)) {
+            else if(that.template is<Empty>() || is_any()) {
                 return *this;
             }
             else {
@@ -192,13 +335,13 @@ namespace tfl {
          * - \f$ r \cdot \varepsilon \equiv r \f$
          */
         Regex operator-(Regex const& that) const {
-            if(is_empty(*this) || is_empty(that)) {
+            if(is<Empty>() || that.template is<Empty>()) {
                 return empty();
             }
-            else if(is_epsilon(*this)) {
+            else if(is<Epsilon>()) {
                 return that;
             }
-            else if(is_epsilon(that)) {
+            else if(that.template is<Epsilon>()) {
                 return *this;
             }
             else {
@@ -218,13 +361,13 @@ namespace tfl {
          * @see <a href="https://en.wikipedia.org/wiki/Kleene_star">Kleene closure</a> on sets.
          */
         Regex operator*() const {
-            if(is_kleene_star(*this)) {
+            if(is<KleeneStar>()) {
                 return *this;
             }
-            else if(is_empty(*this) || is_epsilon(*this)) {
+            else if(is<Empty>() || is<Epsilon>()) {
                 return epsilon();
             }
-            else if(is_alphabet(*this)) {
+            else if(is<Alphabet>()) {
                 return any();
             }
             else {
@@ -239,8 +382,8 @@ namespace tfl {
          * - \f$ \neg\neg r \equiv r \f$;
          */
         Regex operator~() const {
-            if(is_complement(*this)) {
-                return std::get<Complement>(*_regex)._underlying;
+            if(is<Complement>()) {
+                return std::get<Complement>(_regex->variant)._underlying;
             }
             else {
                 return Regex(Complement(*this));
@@ -257,19 +400,56 @@ namespace tfl {
          * - \f$ r \mathbin{\&} \Sigma^{*} \equiv r \f$
          */
         Regex operator&(Regex const& that) const {
-            if(is_empty(*this) || is_empty(that)) {
+            if(is<Empty>() || that.template is<Empty>()) {
                 return empty();
             }
-            else if(is_any(*this)) {
+            else if(is_any()) {
                 return that;
             }
-            else if(is_any(that)) {
+            else if(that.is_any()) {
                 return *this;
             }
             else {
                 return Regex(Conjunction{*this, that});
             }
         }
+
+        /**
+         * @brief \f$ \mathcal{L} = \bigcup_{k = n}^{m} \mathcal{L}(\textup{regex})^{k} \f$
+         *
+         * The repetition is a single node, whatever the bounds: it is derived symbolically 
+         * (\f$ \delta(x,\ r^{\{n,m\}}) = \delta(x,\ r) \cdot r^{\{n-1,m-1\}} \f$), 
+         * and only unrolled by the matchers which do not support it (see \ref unroll()).
+         *
+         * **Used equivalences:**
+         * - \f$ r^{\{0,0\}} \equiv \varepsilon \f$;
+         * - \f$ r^{\{1,1\}} \equiv r \f$;
+         * - \f$ \emptyset^{\{0,m\}} \equiv \varepsilon \f$ and \f$ \emptyset^{\{n,m\}} \equiv \emptyset \f$ if \f$ n > 0 \f$;
+         * - \f$ \varepsilon^{\{n,m\}} \equiv \varepsilon \f$;
+         * - \f$ (r^{*})^{\{n,m\}} \equiv r^{*} \f$
+         *
+         * @param regex \f$ r \f$
+         * @param min \f$ n \f$
+         * @param max \f$ m \f$
+         * @exception std::invalid_argument If \f$ n > m \f$.
+         */
+        static Regex repeat(Regex const& regex, std::size_t min, std::size_t max) {
+            if(min > max) {
+                throw std::invalid_argument("Invalid repetition bounds: {" + std::to_string(min) + "," + std::to_string(max) + "}");
+            }
+            else if(max == 0 || regex.template is<Epsilon>()) {
+                return epsilon();
+            }
+            else if(regex.template is<Empty>()) {
+                return min == 0 ? epsilon() : empty();
+            }
+            else if((min == 1 && max == 1) || regex.template is<KleeneStar>()) {
+                return regex;
+            }
+            else {
+                return Regex(Repetition{regex, min, max});
+            }
+        }
         ///@}
 
 
@@ -289,17 +469,124 @@ namespace tfl {
 
         template<typename R>
         R match(matchers::Base<T, R> const& matcher) const {
-            return std::visit([&matcher](auto r){ return r.match(matcher); }, *_regex);
+            return std::visit([&matcher](auto const& r){ return r.match(matcher); }, _regex->variant);
         }
 
         template<typename R>
         R match(matchers::MutableBase<T, R>& matcher) const {
-            return std::visit([&matcher](auto r){ return r.match(matcher); }, *_regex);
+            return std::visit([&matcher](auto const& r){ return r.match(matcher); }, _regex->variant);
         }
 
         template<typename R>
         R match(matchers::MutableBase<T, R>&& matcher) const {
-            return std::visit([&matcher](auto r){ return r.match(matcher); }, *_regex);
+            return std::visit([&matcher](auto const& r){ return r.match(matcher); }, _regex->variant);
+        }
+        ///@}
+
+        /**
+         * @brief Tests whether two regexes are structurally equal, i.e. built by the same constructors from the same arguments.
+         *
+         * Shared subexpressions are not traversed, and regexes with different hashes (see \ref hash()) are not compared further.
+         * The subexpressions are compared from a worklist, so that comparing deep regexes doesn't overflow the stack.
+         * @note Structurally different regexes may have the same language (e.g. \f$ a \mathbin{|} b \f$ and \f$ b \mathbin{|} a \f$).
+         */
+        bool operator==(Regex const& that) const {
+            std::vector<std::pair<Node const*, Node const*>> worklist{{_regex.get(), that._regex.get()}};
+            while(!worklist.empty()) {
+                auto [left, right] = worklist.back();
+                worklist.pop_back();
+                if(left == right) {
+                    continue;
+                }
+                if(left->meta.hash != right->meta.hash || left->variant.index() != right->variant.index()) {
+                    return false;
+                }
+
+                // Compares the nodes without their subexpressions, which are added to the worklist.
+                bool same = std::visit([&worklist, right](auto const& l) {
+                    using N = std::remove_cvref_t<decltype(l)>;
+                    N const& r = std::get<N>(right->variant);
+                    if constexpr(requires { l._left; }) {
+                        worklist.emplace_back(l._right._regex.get(), r._right._regex.get());
+                        worklist.emplace_back(l._left._regex.get(), r._left._regex.get());
+                        return true;
+                    }
+                    else if constexpr(requires { l._underlying; }) {
+                        worklist.emplace_back(l._underlying._regex.get(), r._underlying._regex.get());
+                        if constexpr(std::same_as<N, Repetition>) {
+                            return l._min == r._min && l._max == r._max;
+                        }
+                        else if constexpr(std::same_as<N, Capture>) {
+                            return l._group == r._group;
+                        }
+                        else {
+                            return true;
+                        }
+                    }
+                    else {
+                        return l == r;
+                    }
+                }, left->variant);
+                if(!same) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Returns a hash of the structure of the regex, in constant time.
+         *
+         * Structurally equal regexes (see \ref operator==()) have the same hash.
+         */
+        std::size_t hash() const noexcept {
+            return meta().hash;
+        }
+
+        /**
+         * @brief Returns an identifier of the root node, shared by the copies of this regex (see \ref matchers::MemoBase).
+         */
+        void const* id() const noexcept {
+            return _regex.get();
+        }
+
+        /**
+         * @name Structural properties
+         * @brief Properties computed when the regex is built, in constant time from those of its subexpressions.
+         * @{
+         */
+
+        /**
+         * @brief Tests whether \f$ \varepsilon \in \mathcal{L} \f$.
+         */
+        bool nullable() const noexcept {
+            return meta().nullable;
+        }
+
+        /**
+         * @brief Returns the number of nodes of the regex (captures are not counted).
+         */
+        std::size_t size() const noexcept {
+            return meta().size;
+        }
+
+        /**
+         * @brief Returns the depth of the regex (captures are not counted).
+         */
+        std::size_t depth() const noexcept {
+            return meta().depth;
+        }
+
+        /**
+         * @brief Tests whether a value may appear in the words of \f$ \mathcal{L} \f$.
+         *
+         * The literals of the regex are summarized by a 64-bit Bloom filter, so false positives are possible.
+         * Regexes containing \f$ \Sigma \f$ or a complement may read any value.
+         *
+         * @return False if no word of \f$ \mathcal{L} \f$ contains `x` (hence if the derivative w.r.t. `x` is empty).
+         */
+        bool may_read(T const& x) const {
+            return meta().open || (meta().literals & literal_bit(x)) != 0;
         }
         ///@}
 
@@ -331,6 +618,34 @@ namespace tfl {
         Regex operator/(Regex const& that) const {
             return *this & ~that;
         }
+
+        /**
+         * @brief \f$ \mathcal{L} = \mathcal{L}(\textup{regex}) \f$, where the matched subsequence is captured as group `group`.
+         *
+         * Captures do not change the language: they are ignored by most operations, and are used
+         * to extract submatches (see \ref TaggedDFA). They are not supported within complements and conjunctions.
+         */
+        static Regex capture(std::size_t group, Regex const& regex) {
+            return Regex(Capture{group, regex});
+        }
+
+        /**
+         * @brief \f$ r^{\{n,m\}} \equiv r^{n} \cdot (\varepsilon \mathbin{|} r \cdot (\varepsilon \mathbin{|} \dots)) \f$, 
+         * with \f$ m - n \f$ optional repetitions.
+         *
+         * The size of the result is proportional to \f$ m \f$: this is the fallback of the matchers which 
+         * do not handle repetitions (see \ref matchers::Base::repetition()).
+         */
+        static Regex unroll(Regex const& regex, std::size_t min, std::size_t max) {
+            Regex result = epsilon();
+            for(std::size_t i = min; i < max; ++i) {
+                result = epsilon() | (regex - result);
+            }
+            for(std::size_t i = 0; i < min; ++i) {
+                result = regex - result;
+            }
+            return result;
+        }
         ///@}
 
     };
@@ -376,6 +691,14 @@ namespace tfl {
         static Regex<T> any() {
             return Regex<T>::any();
         }
+
+        static Regex<T> capture(std::size_t group, Regex<T> const& regex) {
+            return Regex<T>::capture(group, regex);
+        }
+
+        static Regex<T> repeat(Regex<T> const& regex, std::size_t min, std::size_t max) {
+            return Regex<T>::repeat(regex, min, max);
+        }
         ///@}
 
         /**
@@ -390,17 +713,33 @@ namespace tfl {
             return epsilon() | r;
         }
 
+        /**
+         * @brief Makes a regex accepting exactly `count` repetitions of a regex (see \ref Regex::repeat()).
+         */
+        static Regex<T> repeat(Regex<T> const& r, std::size_t count) {
+            return Regex<T>::repeat(r, count, count);
+        }
+
+        /**
+         * @brief Makes a regex accepting at least `min` repetitions of a regex: \f$ r^{\{n,n\}} \cdot r^{*} \f$.
+         */
+        static Regex<T> at_least(Regex<T> const& r, std::size_t min) {
+            return Regex<T>::repeat(r, min, min) - *r;
+        }
+
         /**
          * @brief Makes a regex which only accept the specified sequence.
+         *
+         * The sequence is built as a balanced tree, so that the depth of the regex is logarithmic in the length of the word.
          */
         template<input_range_of<T> C>
         static Regex<T> word(C const& range) {
-            Regex<T> result = Regex<T>::epsilon();
+            std::vector<Regex<T>> literals;
             for(T const& lit : range) {
-                result = result - Regex<T>::literal(lit);
+                literals.push_back(Regex<T>::literal(lit));
             }
 
-            return result;
+            return balanced(std::move(literals), Regex<T>::epsilon(), std::minus<>{});
         }
 
         /**
@@ -412,28 +751,27 @@ namespace tfl {
 
         /**
          * @brief Makes a regex which accepts any of the literal passed as argument.
+         *
+         * The disjunction is built as a balanced tree, so that the depth of the regex is logarithmic in the number of literals.
          */
         template<input_range_of<T> C>
         static Regex<T> any_of(C const& range) {
-            Regex<T> result = Regex<T>::empty();
+            std::vector<Regex<T>> literals;
             for(T const& lit : range) {
-                result = result | Regex<T>::literal(lit);
+                literals.push_back(Regex<T>::literal(lit));
             }
 
-            return result;
+            return balanced(std::move(literals), Regex<T>::empty(), std::bit_or<>{});
         }
 
         /**
          * @brief Makes a regex which accepts any sequence accepted by one of the regex passed as argument.
+         *
+         * The disjunction is built as a balanced tree, so that the depth of the regex is logarithmic in the number of regexes.
          */
         template<input_range_of<Regex<T>> C>
         static Regex<T> any_of(C const& range) {
-            Regex<T> result = Regex<T>::empty();
-            for(Regex<T> const& regex : range) {
-                result = result | regex;
-            }
-
-            return result;
+            return balanced(std::vector<Regex<T>>(std::ranges::begin(range), std::ranges::end(range)), Regex<T>::empty(), std::bit_or<>{});
         }
 
         /**
@@ -456,17 +794,49 @@ namespace tfl {
          */
         template<class Eq = std::equal_to<T>, class Less = std::less<T>>
         static Regex<T> range(T low, T const& high) {
-            if(Less{}(low, high)) {
-                auto c = literal(low); // Variable needed, since c++ doesn't guarantee operands evaluation order
-                return c | range(++low, high); 
+            std::vector<Regex<T>> literals;
+            for(; Less{}(low, high); ++low) {
+                literals.push_back(literal(low));
             }
-            else if(Eq{}(low, high)) {
-                return literal(low);
-            }
-            else {
-                return empty();
+            if(Eq{}(low, high)) {
+                literals.push_back(literal(low));
             }
+
+            return balanced(std::move(literals), empty(), std::bit_or<>{});
         }
         ///@}
+
+    private:
+        // Combines the regexes pairwise, level by level, so that the depth of the result is logarithmic in their number.
+        // The operator must be associative, with `unit` as identity (returned if there are no regexes).
+        template<class Op>
+        static Regex<T> balanced(std::vector<Regex<T>> regexes, Regex<T> const& unit, Op op) {
+            if(regexes.empty()) {
+                return unit;
+            }
+
+            while(regexes.size() > 1) {
+                std::size_t half = (regexes.size() + 1) / 2;
+                for(std::size_t i = 0; i < regexes.size() / 2; ++i) {
+                    regexes[i] = op(regexes[2 * i], regexes[2 * i + 1]);
+                }
+                if(regexes.size() % 2 == 1) {
+                    regexes[half - 1] = std::move(regexes.back());
+                }
+                regexes.erase(regexes.begin() + half, regexes.end());
+            }
+
+            return std::move(regexes.front());
+        }
     };
 }
+
+/**
+ * @brief Hashes regexes by structure (see \ref tfl::Regex::hash()).
+ */
+template<typename T>
+struct std::hash<tfl::Regex<T>> {
+    std::size_t operator()(tfl::Regex<T> const& regex) const noexcept {
+        return regex.hash();
+    }
+};
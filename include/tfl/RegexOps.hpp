@@ -1,8 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <string>
 #include <set>
 #include <ranges>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
 
 #include "Stringify.hpp"
 #include "Concepts.hpp"
@@ -112,6 +118,28 @@ namespace tfl {
              * @param right \f$ r_2 \f$
              */
             virtual R conjunction(Regex<T> const& left, Regex<T> const& right) const = 0;
+
+            /**
+             * @brief Matches the capture of \f$ r \f$ as group `group` (see \ref Regex::capture()).
+             *
+             * Since captures do not change the language, \f$ r \f$ is matched by default.
+             *
+             * @param group The group index.
+             * @param regex \f$ r \f$
+             */
+            virtual R capture(std::size_t group, Regex<T> const& regex) const { return rec(regex); }
+
+            /**
+             * @brief Matches \f$ r^{\{n,m\}} \f$ (see \ref Regex::repeat()).
+             *
+             * By default, the repetition is unrolled (see \ref Regex::unroll()), and the unrolled regex is matched.
+             * Matchers should override it to handle repetitions symbolically.
+             *
+             * @param regex \f$ r \f$
+             * @param min \f$ n \f$
+             * @param max \f$ m \f$
+             */
+            virtual R repetition(Regex<T> const& regex, std::size_t min, std::size_t max) const { return rec(Regex<T>::unroll(regex, min, max)); }
         };
 
         /**
@@ -144,6 +172,214 @@ namespace tfl {
             virtual R kleene_star(Regex<T> const& regex) = 0;
             virtual R complement(Regex<T> const& regex) = 0;
             virtual R conjunction(Regex<T> const& left, Regex<T> const& right) = 0;
+            virtual R capture(std::size_t group, Regex<T> const& regex) { return rec(regex); }
+            virtual R repetition(Regex<T> const& regex, std::size_t min, std::size_t max) { return rec(Regex<T>::unroll(regex, min, max)); }
+        };
+
+        namespace {
+            // The direct subexpressions of a node (null if absent), which remain valid as long as the node.
+            template<typename T>
+            class Children final: public Base<T, std::array<Regex<T> const*, 2>> {
+                using Result = std::array<Regex<T> const*, 2>;
+            public:
+                Result empty() const { return {}; }
+                Result epsilon() const { return {}; }
+                Result alphabet() const { return {}; }
+                Result literal(T const&) const { return {}; }
+                Result disjunction(Regex<T> const& left, Regex<T> const& right) const { return {&left, &right}; }
+                Result sequence(Regex<T> const& left, Regex<T> const& right) const { return {&left, &right}; }
+                Result kleene_star(Regex<T> const& regex) const { return {&regex, nullptr}; }
+                Result complement(Regex<T> const& regex) const { return {&regex, nullptr}; }
+                Result conjunction(Regex<T> const& left, Regex<T> const& right) const { return {&left, &right}; }
+                Result capture(std::size_t, Regex<T> const& regex) const { return {&regex, nullptr}; }
+                Result repetition(Regex<T> const& regex, std::size_t, std::size_t) const { return {&regex, nullptr}; }
+            };
+            template<typename T> constexpr Children<T> children{};
+        }
+
+        /**
+         * @brief %Base of the matchers memoizing their result for each node.
+         *
+         * Copies of a regex share its nodes, so a regex is a DAG, in which a subexpression may be reached 
+         * through several parents. Matching the subexpressions with \ref memo() rather than \ref rec(), 
+         * each node is only matched once by a matcher: a traversal costs O(unique nodes), instead of O(size of the tree).
+         *
+         * The results are kept as long as the matcher, as well as the matched nodes (so that they are not reused).
+         * Matchers whose results are large (e.g. automata) can instead release the result of a subexpression
+         * once all its parents are matched (see \ref MemoBase(bool)).
+         *
+         * The nodes are matched in post-order, using an explicit stack: when a node is matched, \ref memo() 
+         * only looks up the results of its subexpressions. Matchers which only memoize the direct subexpressions of
+         * the matched nodes can then traverse regexes of any depth, without overflowing the call stack.
+         *
+         * @tparam T The input type of the regexes.
+         * @tparam R The returned type of the matcher.
+         *
+         * @see \ref MutableBase for a complete documentation of all members.
+         */
+        template<typename T, typename R>
+        class MemoBase: public MutableBase<T, R> {
+            std::unordered_map<void const*, std::pair<Regex<T>, R>> _memo;
+            bool _retain;
+            // Number of parents not matched yet of the subexpressions, if their results are not retained.
+            std::unordered_map<void const*, std::size_t> _parents;
+
+            void count_parents(Regex<T> const& regex) {
+                std::vector<Regex<T> const*> stack{&regex};
+                while(!stack.empty()) {
+                    Regex<T> const* node = stack.back();
+                    stack.pop_back();
+                    for(Regex<T> const* child: node->match(children<T>)) {
+                        if(child && !_memo.contains(child->id()) && _parents[child->id()]++ == 0) {
+                            stack.push_back(child);
+                        }
+                    }
+                }
+            }
+
+            void release_children(Regex<T> const& node) {
+                for(Regex<T> const* child: node.match(children<T>)) {
+                    if(!child) {
+                        continue;
+                    }
+                    if(auto it = _parents.find(child->id()); it != _parents.end() && --it->second == 0) {
+                        _parents.erase(it);
+                        _memo.erase(child->id());
+                    }
+                }
+            }
+
+        protected:
+            /**
+             * @param retain Whether to keep the results of the subexpressions. If not, only the results of the regexes 
+             * passed to \ref memo() are kept: the result of a subexpression is released once all its parents are matched.
+             */
+            MemoBase(bool retain = true): _retain(retain) {}
+
+        public:
+            /**
+             * @brief Matches a regex with this matcher, unless the same node was already matched.
+             *
+             * @param regex The regex on which match.
+             * @return The result of the match (which stays valid as long as the matcher).
+             */
+            R const& memo(Regex<T> const& regex) {
+                if(auto it = _memo.find(regex.id()); it != _memo.end()) {
+                    return it->second.second;
+                }
+
+                if(!_retain) {
+                    count_parents(regex);
+                }
+
+                // A node is pushed twice: to push its subexpressions, then (once they are matched) to be matched.
+                std::vector<std::pair<Regex<T> const*, bool>> stack{{&regex, false}};
+                while(!stack.empty()) {
+                    auto [node, expanded] = stack.back();
+                    if(_memo.contains(node->id())) {
+                        stack.pop_back();
+                    }
+                    else if(!expanded) {
+                        stack.back().second = true;
+                        auto [left, right] = node->match(children<T>);
+                        for(Regex<T> const* child: {right, left}) {
+                            if(child && !_memo.contains(child->id())) {
+                                stack.emplace_back(child, false);
+                            }
+                        }
+                    }
+                    else {
+                        stack.pop_back();
+                        R result = node->match(*this);
+                        _memo.try_emplace(node->id(), *node, std::move(result));
+                        if(!_retain) {
+                            release_children(*node);
+                        }
+                    }
+                }
+
+                return _memo.find(regex.id())->second.second;
+            }
+
+            virtual R capture(std::size_t, Regex<T> const& regex) override { return memo(regex); }
+            virtual R repetition(Regex<T> const& regex, std::size_t min, std::size_t max) override { return memo(Regex<T>::unroll(regex, min, max)); }
+        };
+
+        /**
+         * @brief %Base of the matchers which recurse into the subexpressions they need, unless these are deep.
+         *
+         * The subexpressions are matched with \ref sub(): recursively if they are shallow, so that shallow regexes are
+         * matched without bookkeeping, and from an explicit stack otherwise. A node which needs a deep subexpression
+         * not matched yet is matched again after it, the result of the subexpression being that of \f$ \emptyset \f$
+         * meanwhile. Hence, the matchers can skip some subexpressions depending on the others (unlike \ref MemoBase,
+         * which matches every subexpression first), and match regexes of any depth without overflowing the call stack.
+         *
+         * The results of the deep nodes are memoized. As a node may be matched several times, matching must not have 
+         * side effects, and must only match the subexpressions of the node (not regexes built from them).
+         *
+         * @tparam T The input type of the regexes.
+         * @tparam R The returned type of the matcher.
+         *
+         * @see \ref MutableBase for a complete documentation of all members.
+         */
+        template<typename T, typename R>
+        class LazyBase: public MutableBase<T, R> {
+            std::unordered_map<void const*, std::pair<Regex<T>, R>> _memo;
+            // The deep subexpressions not matched yet which the matched node needs, while traversing.
+            std::vector<Regex<T>> _missing;
+            bool _traversing = false;
+
+        public:
+            /**
+             * @brief The depth above which the subexpressions are matched from the explicit stack.
+             */
+            static constexpr std::size_t max_recursion = 256;
+
+            /**
+             * @brief Matches a regex with this matcher, or a subexpression of the matched node.
+             *
+             * @param regex The regex on which match.
+             * @return The result of the match.
+             */
+            R sub(Regex<T> const& regex) {
+                if(regex.depth() <= max_recursion) {
+                    return this->rec(regex);
+                }
+                if(auto it = _memo.find(regex.id()); it != _memo.end()) {
+                    return it->second.second;
+                }
+                if(_traversing) {
+                    _missing.push_back(regex);
+                    return this->empty();
+                }
+
+                _traversing = true;
+                std::vector<Regex<T>> stack{regex};
+                while(!stack.empty()) {
+                    Regex<T> const& node = stack.back();
+                    if(_memo.contains(node.id())) {
+                        stack.pop_back();
+                        continue;
+                    }
+
+                    _missing.clear();
+                    R result = node.match(*this);
+                    if(_missing.empty()) {
+                        _memo.try_emplace(node.id(), node, std::move(result));
+                        stack.pop_back();
+                    }
+                    else {
+                        stack.insert(stack.end(), _missing.begin(), _missing.end());
+                    }
+                }
+                _traversing = false;
+
+                return _memo.find(regex.id())->second.second;
+            }
+
+            virtual R capture(std::size_t, Regex<T> const& regex) override { return sub(regex); }
+            // The retried nodes must find the results of the same nodes: repetitions are not unrolled.
+            virtual R repetition(Regex<T> const& regex, std::size_t min, std::size_t max) override = 0;
         };
 
         /**
@@ -162,6 +398,8 @@ namespace tfl {
             virtual bool kleene_star(Regex<T> const& regex) const { return false; }
             virtual bool complement(Regex<T> const& regex) const { return false; }
             virtual bool conjunction(Regex<T> const& left, Regex<T> const& right) const { return false; }
+            virtual bool capture(std::size_t group, Regex<T> const& regex) const { return false; }
+            virtual bool repetition(Regex<T> const& regex, std::size_t min, std::size_t max) const { return false; }
         };
 
         namespace {
@@ -211,159 +449,314 @@ namespace tfl {
                 CONJ = 3,
                 DISJ = 4,
             };
-            template<typename T, typename Stringify>
-            class Printer final: public Base<T, std::pair<std::string, Precedence>> {
-                using Result = std::pair<std::string, Precedence>;
-                using Base<T, Result>::rec;
-
+            template<typename T>
+            class PrecedenceOf final: public Base<T, Precedence> {
+            public:
+                Precedence empty() const { return Precedence::ATOM; }
+                Precedence epsilon() const { return Precedence::ATOM; }
+                Precedence alphabet() const { return Precedence::ATOM; }
+                Precedence literal(T const&) const { return Precedence::ATOM; }
+                Precedence disjunction(Regex<T> const&, Regex<T> const&) const { return Precedence::DISJ; }
+                Precedence sequence(Regex<T> const&, Regex<T> const&) const { return Precedence::SEQ; }
+                Precedence kleene_star(Regex<T> const&) const { return Precedence::ATOM; }
+                Precedence complement(Regex<T> const&) const { return Precedence::ATOM; }
+                Precedence conjunction(Regex<T> const&, Regex<T> const&) const { return Precedence::CONJ; }
+                Precedence capture(std::size_t, Regex<T> const&) const { return Precedence::ATOM; }
+                Precedence repetition(Regex<T> const&, std::size_t, std::size_t) const { return Precedence::ATOM; }
+            };
+            template<typename T> constexpr PrecedenceOf<T> precedence_of{};
 
-                inline static std::string paren_if_gtr(Result const& r, Precedence pri) {
-                    return r.second > pri ? '(' + r.first + ')' : r.first;
+            // Prints the regexes from left to right, using an explicit stack of pieces (text or subexpressions),
+            // so that the depth of the printed regex is not limited by the call stack.
+            template<typename T, typename Stringify>
+            class Printer final: public MutableBase<T, void> {
+                std::vector<std::variant<std::string, Regex<T> const*>> _pieces;
+
+                // The pieces are pushed in reverse order.
+                void operand(Regex<T> const& regex, bool paren) {
+                    if(paren) {
+                        _pieces.emplace_back(")");
+                    }
+                    _pieces.emplace_back(&regex);
+                    if(paren) {
+                        _pieces.emplace_back("(");
+                    }
                 }
 
-                inline static std::string paren_if_geq(Result const& r, Precedence pri) {
-                    return r.second >= pri ? '(' + r.first + ')' : r.first;
+                void unop_rightassoc(std::string op, Regex<T> const& regex, Precedence pri) {
+                    operand(regex, regex.match(precedence_of<T>) > pri);
+                    _pieces.emplace_back(std::move(op));
                 }
 
-                inline static Result unop_rightassoc(std::string const& op, Result const& r, Precedence pri) {
-                    return {op + paren_if_gtr(r, pri), pri};
+                void binop_leftassoc(std::string op, Regex<T> const& left, Regex<T> const& right, Precedence pri) {
+                    operand(right, right.match(precedence_of<T>) >= pri);
+                    _pieces.emplace_back(std::move(op));
+                    operand(left, left.match(precedence_of<T>) > pri);
                 }
 
-                inline static Result binop_leftassoc(std::string const& op, Result const& l, Result const& r, Precedence pri) {
-                    return {paren_if_gtr(l, pri) + op + paren_if_geq(r, pri), pri};
+            public:
+                std::string print(Regex<T> const& regex) {
+                    std::string result;
+                    _pieces.emplace_back(&regex);
+                    while(!_pieces.empty()) {
+                        auto piece = std::move(_pieces.back());
+                        _pieces.pop_back();
+                        if(auto const* text = std::get_if<std::string>(&piece)) {
+                            result += *text;
+                        }
+                        else {
+                            std::get<Regex<T> const*>(piece)->match(*this);
+                        }
+                    }
+                    return result;
                 }
 
-            public:
-                Result empty() const { return {"∅", Precedence::ATOM}; }
-                Result epsilon() const { return {"ε", Precedence::ATOM}; }
-                Result alphabet() const { return {"Σ", Precedence::ATOM}; }
-                Result literal(T const& lit) const { return {Stringify::convert(lit), Precedence::ATOM}; }
-                Result disjunction(Regex<T> const& left, Regex<T> const& right) const { 
-                    return binop_leftassoc(" | ", rec(left), rec(right), Precedence::DISJ);
+                void empty() { _pieces.emplace_back("∅"); }
+                void epsilon() { _pieces.emplace_back("ε"); }
+                void alphabet() { _pieces.emplace_back("Σ"); }
+                void literal(T const& lit) { _pieces.emplace_back(Stringify::convert(lit)); }
+                void disjunction(Regex<T> const& left, Regex<T> const& right) { 
+                    binop_leftassoc(" | ", left, right, Precedence::DISJ);
+                }
+                void sequence(Regex<T> const& left, Regex<T> const& right) {
+                    binop_leftassoc("", left, right, Precedence::SEQ);
                 }
-                Result sequence(Regex<T> const& left, Regex<T> const& right) const {
-                    return binop_leftassoc("", rec(left), rec(right), Precedence::SEQ);
+                void kleene_star(Regex<T> const& regex) {
+                    unop_rightassoc("*", regex, Precedence::ATOM);
                 }
-                Result kleene_star(Regex<T> const& regex) const {
-                    return unop_rightassoc("*", rec(regex), Precedence::ATOM);
+                void complement(Regex<T> const& regex) {
+                    unop_rightassoc("¬", regex, Precedence::ATOM);
                 }
-                Result complement(Regex<T> const& regex) const {
-                    return unop_rightassoc("¬", rec(regex), Precedence::ATOM);
+                void conjunction(Regex<T> const& left, Regex<T> const& right) { 
+                    binop_leftassoc(" & ", left, right, Precedence::CONJ);
                 }
-                Result conjunction(Regex<T> const& left, Regex<T> const& right) const { 
-                    return binop_leftassoc(" & ", rec(left), rec(right), Precedence::CONJ);
+                void capture(std::size_t group, Regex<T> const& regex) {
+                    _pieces.emplace_back(">");
+                    operand(regex, false);
+                    _pieces.emplace_back('<' + std::to_string(group) + ':');
+                }
+                void repetition(Regex<T> const& regex, std::size_t min, std::size_t max) {
+                    std::string bounds = min == max ? std::to_string(min) : std::to_string(min) + ',' + std::to_string(max);
+                    unop_rightassoc('{' + bounds + '}', regex, Precedence::ATOM);
                 }
             };
-            template<typename T, typename Stringify> constexpr Printer<T, Stringify> printer{};
 
 
 
-            template<typename T, class Eq>
-            class NullabilityChecker final: public Base<T, bool> {
-                using Base<T, bool>::rec;
+            // Conservative emptiness test of the languages of a regex and of its complement: returns whether each is empty.
+            // Misses some empty languages, but never reports a nonempty one.
+            template<typename T>
+            class EmptinessChecker final: public LazyBase<T, std::pair<bool, bool>> {
+                using Result = std::pair<bool, bool>;
+
+                // Whether one regex is the complement of the other (i.e. `left == ~right`, without building `~right`).
+                static bool complementary(Regex<T> const& left, Regex<T> const& right) {
+                    auto complement_of = [](Regex<T> const& regex, Regex<T> const& other) {
+                        return regex.match(is_complement<T>) && *regex.match(children<T>)[0] == other;
+                    };
+                    return complement_of(right, left) || complement_of(left, right);
+                }
+
             public:
-                bool empty() const { return false; }
-                bool epsilon() const { return true; }
-                bool alphabet() const { return false; }
-                bool literal(T const&) const { return false; }
-                bool disjunction(Regex<T> const& left, Regex<T> const& right) const { return rec(left) || rec(right); }
-                bool sequence(Regex<T> const& left, Regex<T> const& right) const { return rec(left) && rec(right); }
-                bool kleene_star(Regex<T> const&) const { return true; }  
-                bool complement(Regex<T> const& regex) const { return !rec(regex); }  
-                bool conjunction(Regex<T> const& left, Regex<T> const& right) const { return rec(left) && rec(right); }
+                using LazyBase<T, Result>::sub;
+
+                Result empty() { return {true, false}; }
+                Result epsilon() { return {false, false}; }
+                Result alphabet() { return {false, false}; }
+                Result literal(T const&) { return {false, false}; }
+                Result disjunction(Regex<T> const& left, Regex<T> const& right) { 
+                    auto [l, l_complement] = sub(left);
+                    auto [r, r_complement] = sub(right);
+                    return {l && r, l_complement || r_complement || complementary(left, right)}; 
+                }
+                Result sequence(Regex<T> const& left, Regex<T> const& right) { 
+                    auto [l, l_complement] = sub(left);
+                    auto [r, r_complement] = sub(right);
+                    return {l || r, l_complement && r_complement}; 
+                }
+                Result kleene_star(Regex<T> const& regex) { 
+                    return {false, regex.match(is_alphabet<T>) || sub(regex).second}; 
+                }
+                Result complement(Regex<T> const& regex) { 
+                    auto [r, r_complement] = sub(regex);
+                    return {r_complement, r};
+                }
+                Result conjunction(Regex<T> const& left, Regex<T> const& right) { 
+                    auto [l, l_complement] = sub(left);
+                    auto [r, r_complement] = sub(right);
+                    return {l || r || complementary(left, right), l_complement && r_complement}; 
+                }
+                // The upper bound is at least 1 (see Regex::repeat()).
+                Result repetition(Regex<T> const& regex, std::size_t min, std::size_t) {
+                    auto [r, r_complement] = sub(regex);
+                    return {min > 0 && r, r_complement};
+                }
             };
-            template<typename T, class Eq> constexpr NullabilityChecker<T, Eq> nullability_checker{};
 
 
 
             template<typename T, class Eq>
-            class Deriver final: public Base<T, Regex<T>> {
-                using Base<T, Regex<T>>::rec;
+            class Deriver final: public LazyBase<T, Regex<T>> {
                 static Eq constexpr eq{};
                 T const& _x;
+
+                // Subexpressions which cannot read the value are not traversed.
+                Regex<T> derive(Regex<T> const& regex) {
+                    if constexpr(std::is_same_v<Eq, std::equal_to<T>>) {
+                        if(!regex.may_read(_x)) {
+                            return Regex<T>::empty();
+                        }
+                    }
+                    return sub(regex);
+                }
+
             public:
+                using LazyBase<T, Regex<T>>::sub;
+
                 Deriver(T const& x): _x(x) {}
 
-                Regex<T> empty() const { return Regex<T>::empty(); }
-                Regex<T> epsilon() const { return Regex<T>::empty(); }
-                Regex<T> alphabet() const { return Regex<T>::epsilon(); }
-                Regex<T> literal(T const& literal) const { return eq(literal, _x) ? Regex<T>::epsilon() : Regex<T>::empty(); }
-                Regex<T> disjunction(Regex<T> const& left, Regex<T> const& right) const { return rec(left) | rec(right); }
-                Regex<T> sequence(Regex<T> const& left, Regex<T> const& right) const {
-                    auto d = rec(left) - right;
-                    return left.match(nullability_checker<T, Eq>) ? d | rec(right) : d;
-                }
-                Regex<T> kleene_star(Regex<T> const& regex) const { return rec(regex) - *regex; }
-                Regex<T> complement(Regex<T> const& regex) const { return ~rec(regex); }  
-                Regex<T> conjunction(Regex<T> const& left, Regex<T> const& right) const { return rec(left) & rec(right); }
+                Regex<T> empty() { return Regex<T>::empty(); }
+                Regex<T> epsilon() { return Regex<T>::empty(); }
+                Regex<T> alphabet() { return Regex<T>::epsilon(); }
+                Regex<T> literal(T const& literal) { return eq(literal, _x) ? Regex<T>::epsilon() : Regex<T>::empty(); }
+                Regex<T> disjunction(Regex<T> const& left, Regex<T> const& right) { return derive(left) | derive(right); }
+                Regex<T> sequence(Regex<T> const& left, Regex<T> const& right) {
+                    auto d = derive(left) - right;
+                    return left.nullable() ? d | derive(right) : d;
+                }
+                Regex<T> kleene_star(Regex<T> const& regex) { return derive(regex) - *regex; }
+                Regex<T> complement(Regex<T> const& regex) { return ~sub(regex); }  
+                Regex<T> conjunction(Regex<T> const& left, Regex<T> const& right) { return derive(left) & derive(right); }
+                Regex<T> repetition(Regex<T> const& regex, std::size_t min, std::size_t max) { 
+                    return derive(regex) - Regex<T>::repeat(regex, min == 0 ? 0 : min - 1, max - 1); 
+                }
             };
 
+            // Antimirov's partial derivatives: a set of regexes (without ∅ nor duplicates), whose union is the derivative.
+            template<typename T, class Eq>
+            class PartialDeriver final: public LazyBase<T, std::vector<Regex<T>>> {
+                using Terms = std::vector<Regex<T>>;
+                static Eq constexpr eq{};
+                // Null for a value which is not a literal of the regex, only read by Σ.
+                T const* _x;
+
+                Terms derive(Regex<T> const& regex) {
+                    if constexpr(std::is_same_v<Eq, std::equal_to<T>>) {
+                        if(_x && !regex.may_read(*_x)) {
+                            return {};
+                        }
+                    }
+                    return sub(regex);
+                }
 
+                static void add(Terms& terms, Regex<T> const& term) {
+                    auto equal = [&term](Regex<T> const& t){ return t.hash() == term.hash() && t == term; };
+                    if(!term.match(is_empty<T>) && std::ranges::none_of(terms, equal)) {
+                        terms.push_back(term);
+                    }
+                }
 
-            template<typename T, class R>
-            class AlphabetFinder final: public Base<T, R> {
-                using Base<T, R>::rec;
-            public:
+                static Terms unite(Terms left, Terms const& right) {
+                    for(auto const& term: right) {
+                        add(left, term);
+                    }
+                    return left;
+                }
 
-                R empty() const { return R{}; }
-                R epsilon() const { return R{}; }
-                R alphabet() const { return R{}; }
-                R literal(T const& literal) const  { return R{literal}; }
-                R disjunction(Regex<T> const& left, Regex<T> const& right) const { 
-                    R l(rec(left));
-                    l.merge(rec(right));
-                    return l; 
-                }
-                R sequence(Regex<T> const& left, Regex<T> const& right) const { 
-                    R l(rec(left));
-                    l.merge(rec(right));
-                    return l; 
-                }
-                R kleene_star(Regex<T> const& regex) const { return rec(regex); }
-                R complement(Regex<T> const& regex) const { return rec(regex); }
-                R conjunction(Regex<T> const& left, Regex<T> const& right) const { 
-                    R l(rec(left));
-                    l.merge(rec(right));
-                    return l; 
+            public:
+                using LazyBase<T, Terms>::sub;
+
+                PartialDeriver(T const* x): _x(x) {}
+
+                Terms empty() { return {}; }
+                Terms epsilon() { return {}; }
+                Terms alphabet() { return {Regex<T>::epsilon()}; }
+                Terms literal(T const& literal) { 
+                    if(_x && eq(literal, *_x)) {
+                        return {Regex<T>::epsilon()};
+                    }
+                    return {}; 
+                }
+                Terms disjunction(Regex<T> const& left, Regex<T> const& right) { return unite(derive(left), derive(right)); }
+                Terms sequence(Regex<T> const& left, Regex<T> const& right) {
+                    Terms terms;
+                    for(auto const& term: derive(left)) {
+                        add(terms, term - right);
+                    }
+                    return left.nullable() ? unite(std::move(terms), derive(right)) : terms;
+                }
+                Terms kleene_star(Regex<T> const& regex) {
+                    Terms terms;
+                    for(auto const& term: derive(regex)) {
+                        add(terms, term - *regex);
+                    }
+                    return terms;
+                }
+                // The complement of a union is not a union: the terms are joined.
+                Terms complement(Regex<T> const& regex) {
+                    Regex<T> joined = Regex<T>::empty();
+                    for(auto const& term: sub(regex)) {
+                        joined = joined | term;
+                    }
+                    Terms terms;
+                    add(terms, ~joined);
+                    return terms;
+                }
+                Terms conjunction(Regex<T> const& left, Regex<T> const& right) {
+                    Terms terms;
+                    Terms r = derive(right);
+                    for(auto const& l: derive(left)) {
+                        for(auto const& term: r) {
+                            add(terms, l & term);
+                        }
+                    }
+                    return terms;
+                }
+                Terms repetition(Regex<T> const& regex, std::size_t min, std::size_t max) {
+                    Terms terms;
+                    Regex<T> rest = Regex<T>::repeat(regex, min == 0 ? 0 : min - 1, max - 1);
+                    for(auto const& term: derive(regex)) {
+                        add(terms, term - rest);
+                    }
+                    return terms;
                 }
             };
-            template<typename T, class R> constexpr AlphabetFinder<T, R> alphabet_finder{};
 
 
 
-            template<typename T>
-            class DepthProbe: public Base<T, std::size_t> {
-                using Size = std::size_t;
-                using Base<T, Size>::rec;
-            public:
-                Size empty() const { return 1; }
-                Size epsilon() const { return 1; }
-                Size alphabet() const { return 1; }
-                Size literal(T const&) const { return 1; }
-                Size disjunction(Regex<T> const& left, Regex<T> const& right) const { return std::max(rec(left), rec(right)) + 1; }
-                Size sequence(Regex<T> const& left, Regex<T> const& right) const { return std::max(rec(left), rec(right)) + 1; }
-                Size kleene_star(Regex<T> const& regex) const { return rec(regex) + 1; }
-                Size complement(Regex<T> const& regex) const { return rec(regex) + 1; }
-                Size conjunction(Regex<T> const& left, Regex<T> const& right) const { return std::max(rec(left), rec(right)) + 1; }
-            };
-            template<typename T> constexpr DepthProbe<T> depth_probe{};
+            // Collects the literals of the nodes, and returns whether a node has literals.
+            template<typename T, class R>
+            class AlphabetFinder final: public MemoBase<T, bool> {
+                R _alphabet;
+
+                bool both(Regex<T> const& left, Regex<T> const& right) {
+                    bool l = memo(left);
+                    bool r = memo(right);
+                    return l || r;
+                }
 
-            template<typename T>
-            class Measurer: public Base<T, std::size_t> {
-                using Size = std::size_t;
-                using Base<T, Size>::rec;
             public:
-                Size empty() const { return 1; }
-                Size epsilon() const { return 1; }
-                Size alphabet() const { return 1; }
-                Size literal(T const&) const { return 1; }
-                Size disjunction(Regex<T> const& left, Regex<T> const& right) const { return rec(left) + rec(right) + 1; }
-                Size sequence(Regex<T> const& left, Regex<T> const& right) const { return rec(left) + rec(right) + 1; }
-                Size kleene_star(Regex<T> const& regex) const { return rec(regex) + 1; }
-                Size complement(Regex<T> const& regex) const { return rec(regex) + 1; }
-                Size conjunction(Regex<T> const& left, Regex<T> const& right) const { return rec(left) + rec(right) + 1; }
+                using MemoBase<T, bool>::memo;
+
+                R const& found() const { return _alphabet; }
+
+                bool empty() { return false; }
+                bool epsilon() { return false; }
+                bool alphabet() { return false; }
+                bool literal(T const& literal) { 
+                    _alphabet.insert(literal);
+                    return true; 
+                }
+                bool disjunction(Regex<T> const& left, Regex<T> const& right) { return both(left, right); }
+                bool sequence(Regex<T> const& left, Regex<T> const& right) { return both(left, right); }
+                bool kleene_star(Regex<T> const& regex) { return memo(regex); }
+                bool complement(Regex<T> const& regex) { return memo(regex); }
+                bool conjunction(Regex<T> const& left, Regex<T> const& right) { return both(left, right); }
+                bool repetition(Regex<T> const& regex, std::size_t, std::size_t) { return memo(regex); }
             };
-            template<typename T> constexpr Measurer<T> measurer{};
+
+
+
         }
 
         
@@ -424,10 +817,25 @@ namespace tfl {
 
     /**
      * @brief Tests whether \f$ \varepsilon \in \mathcal{L}(r) \f$
+     *
+     * Constant time: the nullability is computed when the regex is built (see \ref Regex::nullable()).
      */
     template<typename T, class Eq = std::equal_to<T>>
     inline bool is_nullable(Regex<T> const& r) {
-        return r.match(matchers::nullability_checker<T, Eq>);
+        return r.nullable();
+    }
+
+    /**
+     * @brief Tests whether \f$ \mathcal{L}(r) = \emptyset \f$, conservatively.
+     *
+     * Unlike \ref is_empty(), the languages which are empty without being written \f$ \emptyset \f$ are detected,
+     * such as \f$ a \mathbin{\&} \neg a \f$ or \f$ a \cdot \neg\Sigma^{*} \f$. The test only traverses the regex
+     * (complementary subexpressions are found by structural equality), so some empty languages are missed,
+     * but a nonempty language is never reported as empty.
+     */
+    template<typename T>
+    inline bool has_empty_language(Regex<T> const& r) {
+        return matchers::EmptinessChecker<T>{}.sub(r).first;
     }
 
     /**
@@ -440,7 +848,9 @@ namespace tfl {
      */
     template<typename T, class R = std::set<T>>
     R generate_minimal_alphabet(Regex<T> const& regex) {
-        return regex.match(matchers::alphabet_finder<T, R>);
+        matchers::AlphabetFinder<T, R> finder;
+        finder.memo(regex);
+        return finder.found();
     }
 
     /**
@@ -467,7 +877,12 @@ namespace tfl {
 
     template<typename T, class Eq = std::equal_to<T>>
     inline Regex<T> derive(T const& x, Regex<T> const& regex) {
-        return regex.match(matchers::Deriver<T, Eq>{x});
+        if constexpr(std::is_same_v<Eq, std::equal_to<T>>) {
+            if(!regex.may_read(x)) {
+                return Regex<T>::empty();
+            }
+        }
+        return matchers::Deriver<T, Eq>{x}.sub(regex);
     }
 
     template<typename T, input_range_of<T> R, class Eq = std::equal_to<T>>
@@ -483,6 +898,22 @@ namespace tfl {
 
         return res;
     }
+
+    /**
+     * @brief Computes the partial derivatives of a regex w.r.t. a literal.
+     *
+     * The partial derivatives are a set of regexes whose union is equivalent to the derivative \f$ \delta(x,\ r) \f$:
+     * disjunctions are split instead of derived as a whole. There are finitely many partial derivatives
+     * w.r.t. all strings, which are the states of the partial-derivative automaton (see \ref make_nfa_by_partial_derivatives()).
+     *
+     * @return The partial derivatives, without \f$ \emptyset \f$ nor duplicates (by structural equality).
+     *
+     * @see V. Antimirov, <i>Partial derivatives of regular expressions and finite automaton constructions</i>.
+     */
+    template<typename T, class Eq = std::equal_to<T>>
+    std::vector<Regex<T>> partial_derive(T const& x, Regex<T> const& regex) {
+        return matchers::PartialDeriver<T, Eq>{&x}.sub(regex);
+    }
     ///@}
 
     /**
@@ -497,7 +928,8 @@ namespace tfl {
      * - Sequence is implicit;
      * - Kleene star is (left-)unary operator '*';
      * - Complement is (left-)unary operator '¬';
-     * - Conjunction is binary operator '&'.
+     * - Conjunction is binary operator '&';
+     * - Captures are represented as '<group:regex>'.
      *
      * The operators are bound in the following (from most to least binding) order: 
      * 1. Kleene Star/Complement;
@@ -507,7 +939,7 @@ namespace tfl {
      */
     template<typename T, class Stringify = Stringify<T>>
     inline std::string to_string(Regex<T> const& regex) {
-        return regex.match(matchers::printer<T, Stringify>).first;
+        return matchers::Printer<T, Stringify>().print(regex);
     }
 
     /**
@@ -516,19 +948,19 @@ namespace tfl {
      * @{
      */
     /**
-     * @brief Computes the depth of the regex.
+     * @brief Returns the depth of the regex, in constant time (see \ref Regex::depth()).
      */
     template<typename T>
     std::size_t depth(Regex<T> const& regex) {
-        return regex.match(matchers::depth_probe<T>);
+        return regex.depth();
     }
 
     /**
-     * @brief Computes the size of the regex.
+     * @brief Returns the size of the regex, in constant time (see \ref Regex::size()).
      */
     template<typename T>
     std::size_t size(Regex<T> const& regex) {
-        return regex.match(matchers::measurer<T>);
+        return regex.size();
     }
     ///@}
 }
\ No newline at end of file
@@ -0,0 +1,396 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <queue>
+#include <ranges>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "Automata.hpp"
+#include "AutomataOps.hpp"
+#include "Regex.hpp"
+#include "Simd.hpp"
+
+/**
+ * @brief Contains functions to search for the matches of a regex within a sequence.
+ * @file
+ */
+
+namespace tfl {
+
+    namespace matchers {
+
+        namespace {
+
+            // Words such that each word of the language starts with one of them,
+            // and whether the language is exactly this set of words.
+            template<typename T>
+            struct Prefixes final {
+                std::set<std::vector<T>> words;
+                bool exact;
+            };
+
+            template<typename T>
+            class PrefixExtractor final: public Base<T, Prefixes<T>> {
+                using Result = Prefixes<T>;
+                using Words = std::set<std::vector<T>>;
+                using Base<T, Result>::rec;
+
+                static constexpr std::size_t MAX_WORDS = 64;
+                static constexpr std::size_t MAX_LENGTH = 8;
+
+                static Result unknown() {
+                    return {Words{std::vector<T>{}}, false};
+                }
+
+                // Truncates the words until the set fits the limits (the truncated words are still prefixes).
+                static Result bounded(Words words, bool exact) {
+                    std::size_t length = 0;
+                    for(auto const& word: words) {
+                        length = std::max(length, word.size());
+                    }
+                    if(words.size() <= MAX_WORDS && length <= MAX_LENGTH) {
+                        return {std::move(words), exact};
+                    }
+
+                    length = std::min(length, MAX_LENGTH + 1);
+                    while(words.size() > MAX_WORDS || length > MAX_LENGTH) {
+                        --length;
+                        Words truncated;
+                        for(auto const& word: words) {
+                            truncated.emplace(word.begin(), word.begin() + std::min(word.size(), length));
+                        }
+                        words = std::move(truncated);
+                    }
+                    return {std::move(words), false};
+                }
+
+                static std::size_t shortest(Words const& words) {
+                    std::size_t length = std::numeric_limits<std::size_t>::max();
+                    for(auto const& word: words) {
+                        length = std::min(length, word.size());
+                    }
+                    return length;
+                }
+
+            public:
+                Result empty() const { return {Words{}, true}; }
+                Result epsilon() const { return {Words{std::vector<T>{}}, true}; }
+                Result alphabet() const { return unknown(); }
+                Result literal(T const& literal) const { return {Words{std::vector<T>{literal}}, true}; }
+                Result disjunction(Regex<T> const& left, Regex<T> const& right) const {
+                    auto l = rec(left);
+                    auto r = rec(right);
+                    l.words.merge(r.words);
+                    return bounded(std::move(l.words), l.exact && r.exact);
+                }
+                Result sequence(Regex<T> const& left, Regex<T> const& right) const {
+                    auto l = rec(left);
+                    if(!l.exact) {
+                        return l;
+                    }
+
+                    auto r = rec(right);
+                    Words words;
+                    for(auto const& u: l.words) {
+                        for(auto const& v: r.words) {
+                            std::vector<T> word(u);
+                            word.insert(word.end(), v.begin(), v.end());
+                            words.insert(std::move(word));
+                        }
+                    }
+                    return bounded(std::move(words), r.exact);
+                }
+                Result kleene_star(Regex<T> const&) const { return unknown(); }
+                Result complement(Regex<T> const&) const { return unknown(); }
+                Result conjunction(Regex<T> const& left, Regex<T> const& right) const {
+                    auto l = rec(left);
+                    auto r = rec(right);
+                    if(l.exact && r.exact) {
+                        Words words;
+                        std::ranges::set_intersection(l.words, r.words, std::inserter(words, words.end()));
+                        return {std::move(words), true};
+                    }
+                    // Both sets are valid; the one with the longest words is the most selective.
+                    return {shortest(l.words) >= shortest(r.words) ? std::move(l.words) : std::move(r.words), false};
+                }
+            };
+            template<typename T> const PrefixExtractor<T> prefix_extractor{};
+        }
+    }
+
+    namespace {
+
+        // Aho-Corasick automaton, reporting the words of a set ending at each position of a sequence.
+        template<typename T>
+        class AhoCorasick final {
+            using StateIdx = std::size_t;
+
+            // Complete transition function on the literals of the words, the others lead to the root.
+            std::unordered_map<T, std::vector<StateIdx>> _transitions;
+            // Lengths of the words recognized when reaching each state.
+            std::vector<std::vector<std::size_t>> _lengths;
+            std::size_t _max_length = 0;
+            // For byte-sized alphabets, the first literals of the words (if there are few of them).
+            std::optional<ByteSet> _first;
+
+        public:
+            explicit AhoCorasick(std::set<std::vector<T>> const& words) {
+                std::vector<std::map<T, StateIdx>> trie(1);
+                for(auto const& word: words) {
+                    StateIdx state = 0;
+                    for(T const& x: word) {
+                        auto [it, inserted] = trie[state].emplace(x, trie.size());
+                        state = it->second;
+                        if(inserted) {
+                            trie.emplace_back();
+                        }
+                    }
+                    _lengths.resize(trie.size());
+                    _lengths[state].push_back(word.size());
+                    _max_length = std::max(_max_length, word.size());
+                }
+                _lengths.resize(trie.size());
+
+                for(auto const& node: trie) {
+                    for(auto const& [x, _]: node) {
+                        _transitions.try_emplace(x, trie.size(), 0);
+                    }
+                }
+
+                // Breadth-first, so that the failure state of a node (which is shallower) is always complete.
+                std::vector<StateIdx> failure(trie.size(), 0);
+                std::queue<StateIdx> queue;
+                queue.push(0);
+                while(!queue.empty()) {
+                    StateIdx state = queue.front();
+                    queue.pop();
+
+                    if(state != 0) {
+                        auto const& inherited = _lengths[failure[state]];
+                        _lengths[state].insert(_lengths[state].end(), inherited.begin(), inherited.end());
+                    }
+
+                    for(auto& [x, row]: _transitions) {
+                        StateIdx fallback = (state == 0) ? 0 : row[failure[state]];
+                        auto child = trie[state].find(x);
+                        if(child == trie[state].end()) {
+                            row[state] = fallback;
+                        }
+                        else {
+                            failure[child->second] = fallback;
+                            row[state] = child->second;
+                            queue.push(child->second);
+                        }
+                    }
+                }
+
+                if constexpr(byte_like<T>) {
+                    ByteSet first;
+                    if(std::ranges::all_of(trie[0], [&first](auto const& p){ return first.insert(static_cast<unsigned char>(p.first)); })) {
+                        _first = first;
+                    }
+                }
+            }
+
+            StateIdx step(StateIdx state, T const& x) const {
+                auto it = _transitions.find(x);
+                return (it != _transitions.cend()) ? it->second[state] : 0;
+            }
+
+            std::vector<std::size_t> const& lengths(StateIdx state) const {
+                return _lengths[state];
+            }
+
+            std::size_t max_length() const {
+                return _max_length;
+            }
+
+            std::optional<ByteSet> const& first() const {
+                return _first;
+            }
+        };
+    }
+
+    /**
+     * @brief Computes literal prefixes of a regex.
+     *
+     * Every sequence in \f$ \mathcal{L}(r) \f$ starts with one of the returned words.
+     * The words are bounded in number and in length, and none of them is a prefix of another.
+     *
+     * @return The prefixes. The set is empty if \f$ \mathcal{L}(r) = \emptyset \f$, and
+     * contains the empty word if no useful prefix could be found.
+     */
+    template<typename T>
+    std::set<std::vector<T>> literal_prefixes(Regex<T> const& regex) {
+        auto words = regex.match(matchers::prefix_extractor<T>).words;
+
+        std::set<std::vector<T>> minimal;
+        for(auto const& word: words) {
+            // Since the words are sorted, a prefix of `word` in the set is the last one kept.
+            if(minimal.empty() || !std::ranges::equal(*minimal.rbegin(), word | std::views::take(minimal.rbegin()->size()))) {
+                minimal.insert(minimal.end(), word);
+            }
+        }
+        return minimal;
+    }
+
+    /**
+     * @brief Searches for the matches of a regex within sequences.
+     *
+     * The matches are found by running a \ref DFA from candidate positions only:
+     * the literal prefixes of the regex (see \ref literal_prefixes()) are searched using an
+     * <a href="https://en.wikipedia.org/wiki/Aho%E2%80%93Corasick_algorithm">Aho-Corasick</a> automaton,
+     * which skips the positions where no prefix starts (using a vectorized search for byte-sized literals,
+     * when the prefixes start with at most \ref ByteSet::CAPACITY different literals).
+     *
+     * When no prefix can be found (e.g. if \f$ \varepsilon \in \mathcal{L}(r) \f$),
+     * the unanchored search of the DFA is used instead (see \ref DFA::find_all()).
+     *
+     * The matches are leftmost-longest: the match starting first is chosen, and it is extended as far as possible.
+     *
+     * @tparam T Type of the alphabet.
+     */
+    template<typename T>
+    class Searcher final {
+        DFA<T> _dfa;
+        std::set<std::vector<T>> _prefixes;
+        std::optional<AhoCorasick<T>> _prefilter;
+
+        template<typename R>
+        std::size_t skip(R const& haystack, std::size_t position) const {
+            if constexpr(byte_like<T> && std::ranges::contiguous_range<R>) {
+                if(_prefilter->first().has_value()) {
+                    auto data = std::ranges::data(haystack);
+                    return _prefilter->first()->find(data + position, data + std::ranges::size(haystack)) - data;
+                }
+            }
+            return position;
+        }
+
+        template<typename R>
+        std::vector<Match> search(R const& haystack, bool first_only) const {
+            std::vector<Match> matches;
+            auto beg = std::ranges::cbegin(haystack);
+            auto end = std::ranges::cend(haystack);
+            std::size_t size = std::ranges::size(haystack);
+            std::size_t next = 0;
+
+            // Runs the DFA from the position, if it is not covered by a previous match.
+            auto verify = [&](std::size_t position) {
+                if(position < next) {
+                    return false;
+                }
+                auto length = _dfa.munch(std::ranges::subrange(beg + position, end));
+                if(!length.has_value()) {
+                    return false;
+                }
+                matches.push_back({position, *length});
+                next = position + std::max<std::size_t>(*length, 1);
+                return true;
+            };
+
+            if(!_prefilter.has_value()) {
+                if(first_only) {
+                    auto match = _dfa.find(haystack);
+                    return match.has_value() ? std::vector<Match>{*match} : std::vector<Match>{};
+                }
+                return _dfa.find_all(haystack);
+            }
+
+            // Candidates are reported by end position: a candidate is only verified once no
+            // prefix ending later can start before it.
+            std::set<std::size_t> pending;
+            std::size_t state = 0;
+            for(std::size_t i = 0; i < size;) {
+                if(state == 0) {
+                    i = skip(haystack, i);
+                    if(i == size) {
+                        break;
+                    }
+                }
+
+                state = _prefilter->step(state, beg[i]);
+                ++i;
+                for(auto length: _prefilter->lengths(state)) {
+                    pending.insert(i - length);
+                }
+
+                while(!pending.empty() && *pending.begin() + _prefilter->max_length() <= i) {
+                    auto position = *pending.begin();
+                    pending.erase(pending.begin());
+                    if(verify(position) && first_only) {
+                        return matches;
+                    }
+                }
+            }
+
+            for(auto position: pending) {
+                if(verify(position) && first_only) {
+                    break;
+                }
+            }
+            return matches;
+        }
+
+    public:
+        /**
+         * @brief Creates a searcher for the regex.
+         */
+        explicit Searcher(Regex<T> const& regex): Searcher(make_dfa(regex), literal_prefixes(regex)) {}
+
+        /**
+         * @brief Creates a searcher from a DFA, and prefixes of its language.
+         *
+         * @param dfa The DFA.
+         * @param prefixes Words such that every sequence accepted by `dfa` starts with one of them.
+         */
+        Searcher(DFA<T> dfa, std::set<std::vector<T>> prefixes): _dfa(std::move(dfa)), _prefixes(std::move(prefixes)) {
+            if(!_prefixes.contains(std::vector<T>{})) {
+                _prefilter.emplace(_prefixes);
+            }
+        }
+
+        /**
+         * @brief Returns the literal prefixes used to find the candidate positions.
+         */
+        std::set<std::vector<T>> const& prefixes() const {
+            return _prefixes;
+        }
+
+        /**
+         * @brief Tests whether the candidate positions are found using the prefixes.
+         */
+        bool has_prefilter() const {
+            return _prefilter.has_value();
+        }
+
+        /**
+         * @brief Finds the leftmost-longest match within the sequence.
+         * @return The match, if any.
+         */
+        template<std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R> && range_of<R, T>
+        std::optional<Match> find_first(R&& haystack) const {
+            auto matches = search(haystack, true);
+            if(matches.empty()) {
+                return std::nullopt;
+            }
+            return matches.front();
+        }
+
+        /**
+         * @brief Finds all the non-overlapping leftmost-longest matches within the sequence, in order.
+         *
+         * The search resumes after the end of each match (or after its position, for empty matches).
+         */
+        template<std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R> && range_of<R, T>
+        std::vector<Match> find_all(R&& haystack) const {
+            return search(haystack, false);
+        }
+    };
+}
@@ -0,0 +1,743 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define TFL_HAS_MMAP 1
+#endif
+
+#include "Regex.hpp"
+#include "Automata.hpp"
+#include "AutomataOps.hpp"
+#include "Concepts.hpp"
+
+/**
+ * @brief Contains the binary serialization of \ref tfl::DFA, and the DFA cache.
+ *
+ * A serialized DFA is laid out as follows (all integers are in native byte order, which is checked when loading):
+ * | Offset | Content |
+ * |--------|---------|
+ * | 0      | Magic number `TFLD` |
+ * | 4      | Format version (`uint32_t`) |
+ * | 8      | Byte order mark (`uint32_t`) |
+ * | 12     | `sizeof(T)` (`uint32_t`) |
+ * | 16     | Number of states \f$ n \f$ (`uint64_t`) |
+ * | 24     | Number of symbols \f$ m = |T^{-}| \f$ (`uint64_t`) |
+ * | 32     | The \f$ m \f$ symbols, sorted |
+ * | aligned on 8 | Transitions (`uint64_t`), row-major: \f$ m + 1 \f$ columns per state, the last one being \f$ \textsc{UNKNOWN} \f$ |
+ * | | Acceptance (one byte per state), padded to a multiple of 8 |
+ *
+ * A DFA set (used for instance to store all the tables of a lexer) is made of the magic number `TFLS`,
+ * the version and the byte order mark, the number of DFAs \f$ k \f$ (`uint64_t`, at offset 16), \f$ k + 1 \f$ offsets
+ * (`uint64_t`) delimiting each DFA, followed by the DFAs themselves.
+ *
+ * Since every table is aligned, loading a serialized DFA does not require any parsing: a \ref tfl::DFAView
+ * reads the tables in place, which allows serialized DFAs to be memory-mapped (see \ref tfl::map_dfa())
+ * and shared by several processes.
+ *
+ * @file
+ */
+
+namespace tfl {
+
+    /**
+     * @brief Exception thrown when (de)serializing automata.
+     */
+    class SerializationException: public std::runtime_error {
+    public:
+        /**
+         * @param what_arg Exception's text.
+         */
+        SerializationException(std::string const& what_arg): runtime_error(what_arg) {}
+    };
+
+    /**
+     * @brief Specifies that a type can be used as the alphabet of a serialized automaton.
+     */
+    template<typename T>
+    concept serializable_literal = std::is_trivially_copyable_v<T> && std::totally_ordered<T> && (alignof(T) <= 8);
+
+    namespace {
+        static constexpr std::array<char, 4> DFA_MAGIC{'T', 'F', 'L', 'D'};
+        static constexpr std::array<char, 4> DFA_SET_MAGIC{'T', 'F', 'L', 'S'};
+        static constexpr std::uint32_t FORMAT_VERSION = 1;
+        static constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+        static constexpr std::uint64_t SERIALIZED_DEAD_STATE = std::numeric_limits<std::uint64_t>::max();
+
+        struct DFAHeader {
+            std::array<char, 4> magic;
+            std::uint32_t version;
+            std::uint32_t byte_order;
+            std::uint32_t symbol_size;
+            std::uint64_t states;
+            std::uint64_t symbols;
+        };
+
+        struct DFASetHeader {
+            std::array<char, 4> magic;
+            std::uint32_t version;
+            std::uint32_t byte_order;
+            std::uint32_t reserved;
+            std::uint64_t count;
+        };
+
+        static_assert(sizeof(DFAHeader) == 32 && sizeof(DFASetHeader) == 24);
+
+        inline constexpr std::size_t align8(std::size_t n) {
+            return (n + 7) & ~std::size_t(7);
+        }
+
+        template<typename T>
+        struct DFALayout {
+            std::size_t symbols;
+            std::size_t transitions;
+            std::size_t accepting;
+            std::size_t size;
+
+            DFALayout(std::size_t states, std::size_t symbol_count):
+            symbols(sizeof(DFAHeader)),
+            transitions(align8(symbols + symbol_count * sizeof(T))),
+            accepting(transitions + states * (symbol_count + 1) * sizeof(std::uint64_t)),
+            size(align8(accepting + states)) {}
+        };
+
+        template<typename V>
+        void write_raw(std::ostream& out, V const& value) {
+            out.write(reinterpret_cast<char const*>(&value), sizeof(V));
+        }
+
+        inline void write_padding(std::ostream& out, std::size_t written) {
+            static constexpr std::array<char, 8> zeros{};
+            out.write(zeros.data(), align8(written) - written);
+        }
+
+        template<typename H>
+        H read_header(std::span<std::byte const> bytes, std::array<char, 4> const& magic) {
+            if(bytes.size() < sizeof(H)) {
+                throw SerializationException("Truncated header.");
+            }
+            if(reinterpret_cast<std::uintptr_t>(bytes.data()) % 8 != 0) {
+                throw SerializationException("Serialized automata must be aligned on 8 bytes.");
+            }
+
+            H header;
+            std::memcpy(&header, bytes.data(), sizeof(H));
+            if(header.magic != magic) {
+                throw SerializationException("Invalid magic number.");
+            }
+            if(header.version != FORMAT_VERSION) {
+                throw SerializationException("Unsupported format version: " + std::to_string(header.version));
+            }
+            if(header.byte_order != BYTE_ORDER_MARK) {
+                throw SerializationException("Serialized with a different byte order.");
+            }
+            return header;
+        }
+
+        // Bytes of a file, memory-mapped whenever possible.
+        class MappedFile final {
+            std::byte const* _data = nullptr;
+            std::size_t _size = 0;
+            std::vector<std::uint64_t> _fallback;
+
+        public:
+            MappedFile(std::filesystem::path const& path) {
+                std::size_t size = std::filesystem::file_size(path);
+#ifdef TFL_HAS_MMAP
+                if(size > 0) {
+                    int fd = ::open(path.c_str(), O_RDONLY);
+                    if(fd >= 0) {
+                        void* ptr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+                        ::close(fd);
+                        if(ptr != MAP_FAILED) {
+                            _data = static_cast<std::byte const*>(ptr);
+                            _size = size;
+                            return;
+                        }
+                    }
+                }
+#endif
+                std::ifstream in(path, std::ios::binary);
+                if(!in) {
+                    throw SerializationException("Cannot open " + path.string());
+                }
+                _fallback.resize(align8(size) / 8);
+                in.read(reinterpret_cast<char*>(_fallback.data()), size);
+                _data = reinterpret_cast<std::byte const*>(_fallback.data());
+                _size = size;
+            }
+
+            MappedFile(MappedFile const&) = delete;
+            MappedFile& operator=(MappedFile const&) = delete;
+
+            ~MappedFile() {
+#ifdef TFL_HAS_MMAP
+                if(_fallback.empty() && _data != nullptr) {
+                    ::munmap(const_cast<std::byte*>(_data), _size);
+                }
+#endif
+            }
+
+            std::span<std::byte const> bytes() const {
+                return {_data, _size};
+            }
+        };
+    }
+
+    /**
+     * @brief Read-only view of a serialized \ref DFA.
+     *
+     * The tables are used in place: no allocation is performed when building a view.
+     * This automaton has the same semantics as a \ref DFA (see the latter for the definitions).
+     *
+     * The layout of the serialized automaton and the targets of its transitions are validated once, when the view
+     * is built, so that corrupted data cannot make the lookups read out of bounds. The symbols are trusted to be sorted.
+     *
+     * @tparam T Type of the alphabet.
+     */
+    template<serializable_literal T>
+    class DFAView final {
+    public:
+        /** @brief Type used to represent states. */
+        using StateIdx = typename DFA<T>::StateIdx;
+
+        /** @brief Index of the dead state. */
+        static constexpr StateIdx const DEAD_STATE = DFA<T>::DEAD_STATE;
+
+    private:
+        std::shared_ptr<void const> _owner;
+        std::span<T const> _symbols;
+        std::uint64_t const* _transitions;
+        std::uint8_t const* _accepting;
+        std::size_t _states;
+
+        std::size_t symbol_class(T const& x) const {
+            auto it = std::lower_bound(_symbols.begin(), _symbols.end(), x);
+            return (it != _symbols.end() && *it == x) ? it - _symbols.begin() : _symbols.size();
+        }
+
+        StateIdx transition_unchecked(StateIdx const& state, T const& x) const {
+            auto to = _transitions[state * (_symbols.size() + 1) + symbol_class(x)];
+            return to == SERIALIZED_DEAD_STATE ? DEAD_STATE : static_cast<StateIdx>(to);
+        }
+
+    public:
+        /**
+         * @brief Creates a view of a serialized DFA.
+         *
+         * @param bytes The serialized DFA; must be aligned on 8 bytes.
+         * @param owner Kept alive as long as the view (or one of its copies) exists.
+         * @exception SerializationException If `bytes` is not a valid serialized DFA over `T`.
+         */
+        DFAView(std::span<std::byte const> bytes, std::shared_ptr<void const> owner = nullptr): _owner(std::move(owner)) {
+            auto header = read_header<DFAHeader>(bytes, DFA_MAGIC);
+            if(header.symbol_size != sizeof(T)) {
+                throw SerializationException("Literal size mismatch.");
+            }
+
+            if(header.states == 0) {
+                throw SerializationException("A DFA must have at least one state.");
+            }
+            // The sizes are bounded before computing the layout, so that it doesn't overflow.
+            if(header.symbols >= bytes.size() / sizeof(T) || header.states > bytes.size() / ((header.symbols + 1) * sizeof(std::uint64_t))) {
+                throw SerializationException("Truncated DFA.");
+            }
+
+            DFALayout<T> layout(header.states, header.symbols);
+            if(bytes.size() < layout.size) {
+                throw SerializationException("Truncated DFA.");
+            }
+
+            _states = header.states;
+            _symbols = {reinterpret_cast<T const*>(bytes.data() + layout.symbols), header.symbols};
+            _transitions = reinterpret_cast<std::uint64_t const*>(bytes.data() + layout.transitions);
+            _accepting = reinterpret_cast<std::uint8_t const*>(bytes.data() + layout.accepting);
+
+            // The targets are used as indices by the lookups, which are unchecked.
+            for(std::size_t i = 0; i < _states * (_symbols.size() + 1); ++i) {
+                if(_transitions[i] >= _states && _transitions[i] != SERIALIZED_DEAD_STATE) {
+                    throw SerializationException("Invalid transition target: " + std::to_string(_transitions[i]));
+                }
+            }
+        }
+
+        /**
+         * @brief Returns the number of states. The dead state is not counted.
+         */
+        StateIdx state_count() const {
+            return _states;
+        }
+
+        /**
+         * @brief Tests whether \f$ \textup{state} \in F\f$.
+         */
+        bool is_accepting(StateIdx const& state) const {
+            return (state == DEAD_STATE) ? false : _accepting[state] != 0;
+        }
+
+        /**
+         * @brief Returns \f$ \delta(\textup{state} \times x) \f$ (\f$ x \f$ might be unknown).
+         * @exception std::invalid_argument If \f$ x \not\in Q \f$.
+         */
+        StateIdx transition(StateIdx const& state, T const& x) const {
+            if(state == DEAD_STATE) {
+                return DEAD_STATE;
+            }
+            if(state >= _states) {
+                throw std::invalid_argument("Invalid non-special state: " + std::to_string(state));
+            }
+            return transition_unchecked(state, x);
+        }
+
+        /**
+         * @brief Returns \f$ T^{-} \f$, sorted.
+         */
+        std::span<T const> alphabet() const {
+            return _symbols;
+        }
+
+        /**
+         * @name Language membership
+         * @see The \ref DFA functions with the same name.
+         * @{
+         */
+        template<input_range_of<T> R>
+        bool accepts(R&& sequence) const noexcept {
+            StateIdx state = 0;
+            for(
+                auto beg = std::ranges::cbegin(sequence), end = std::ranges::cend(sequence);
+                (beg != end) && (state != DEAD_STATE);
+                ++beg
+            ) {
+                state = transition_unchecked(state, *beg);
+            }
+
+            return is_accepting(state);
+        }
+
+        bool accepts(std::initializer_list<T> sequence) const noexcept {
+            return accepts(std::ranges::views::all(sequence));
+        }
+
+        template<input_range_of<T> R>
+        std::optional<std::size_t> munch(R&& sequence) const noexcept {
+            StateIdx state = 0;
+            std::size_t step = 0;
+            std::optional<std::size_t> res = is_accepting(state) ?
+                std::optional<std::size_t>{0} :
+                std::optional<std::size_t>{std::nullopt};
+
+            for(
+                auto beg = std::ranges::cbegin(sequence), end = std::ranges::cend(sequence);
+                (beg != end) && (state != DEAD_STATE);
+                ++beg
+            ) {
+                ++step;
+                state = transition_unchecked(state, *beg);
+
+                if(is_accepting(state)) {
+                    res = step;
+                }
+            }
+
+            return res;
+        }
+
+        std::optional<std::size_t> munch(std::initializer_list<T> sequence) const noexcept {
+            return munch(std::ranges::views::all(sequence));
+        }
+        ///@}
+
+        /**
+         * @brief Copies this automaton into an equivalent \ref DFA.
+         */
+        DFA<T> to_dfa() const {
+            typename DFA<T>::Builder builder(_symbols, _states);
+
+            for(StateIdx i = 0; i < _states; ++i) {
+                auto row = _transitions + i * (_symbols.size() + 1);
+                for(std::size_t c = 0; c < _symbols.size(); ++c) {
+                    builder.set_transition(i, _symbols[c], row[c] == SERIALIZED_DEAD_STATE ? DEAD_STATE : row[c]);
+                }
+                builder.set_unknown_transition(i, row[_symbols.size()] == SERIALIZED_DEAD_STATE ? DEAD_STATE : row[_symbols.size()]);
+                builder.set_acceptance(i, _accepting[i] != 0);
+            }
+
+            return builder;
+        }
+    };
+
+    /**
+     * @brief Read-only view of a serialized set of \ref DFA.
+     *
+     * @see \ref DFAView
+     * @tparam T Type of the alphabet.
+     */
+    template<serializable_literal T>
+    class DFASetView final {
+        std::shared_ptr<void const> _owner;
+        std::span<std::byte const> _bytes;
+        std::uint64_t const* _offsets;
+        std::size_t _count;
+
+    public:
+        /**
+         * @brief Creates a view of a serialized DFA set.
+         *
+         * @param bytes The serialized DFA set; must be aligned on 8 bytes.
+         * @param owner Kept alive as long as the view (or one of the views it creates) exists.
+         * @exception SerializationException If `bytes` is not a valid serialized DFA set.
+         */
+        DFASetView(std::span<std::byte const> bytes, std::shared_ptr<void const> owner = nullptr):
+        _owner(std::move(owner)), _bytes(bytes) {
+            auto header = read_header<DFASetHeader>(bytes, DFA_SET_MAGIC);
+            _count = header.count;
+            if(bytes.size() < sizeof(DFASetHeader) + (_count + 1) * sizeof(std::uint64_t)) {
+                throw SerializationException("Truncated DFA set.");
+            }
+
+            _offsets = reinterpret_cast<std::uint64_t const*>(bytes.data() + sizeof(DFASetHeader));
+            for(std::size_t i = 0; i < _count; ++i) {
+                if(_offsets[i] % 8 != 0 || _offsets[i] > _offsets[i + 1] || _offsets[i + 1] > bytes.size()) {
+                    throw SerializationException("Invalid DFA set offsets.");
+                }
+            }
+        }
+
+        /**
+         * @brief Returns the number of DFAs in the set.
+         */
+        std::size_t size() const {
+            return _count;
+        }
+
+        /**
+         * @brief Returns a view of the i-th DFA.
+         * @exception std::out_of_range If \f$ i \geq \f$ \ref size().
+         */
+        DFAView<T> operator[](std::size_t i) const {
+            if(i >= _count) {
+                throw std::out_of_range("Invalid DFA index: " + std::to_string(i));
+            }
+            return DFAView<T>(_bytes.subspan(_offsets[i], _offsets[i + 1] - _offsets[i]), _owner);
+        }
+    };
+
+    /**
+     * @name Serialization
+     * @{
+     */
+    /**
+     * @brief Writes a DFA in the binary format described in \ref Serialization.hpp.
+     */
+    template<serializable_literal T>
+    void serialize(DFA<T> const& dfa, std::ostream& out) {
+        std::vector<T> symbols(dfa.alphabet().begin(), dfa.alphabet().end());
+        std::sort(symbols.begin(), symbols.end());
+
+        DFAHeader header{DFA_MAGIC, FORMAT_VERSION, BYTE_ORDER_MARK, sizeof(T), dfa.state_count(), symbols.size()};
+        DFALayout<T> layout(dfa.state_count(), symbols.size());
+        auto serialize_state = [](typename DFA<T>::StateIdx state) -> std::uint64_t {
+            return state == DFA<T>::DEAD_STATE ? SERIALIZED_DEAD_STATE : state;
+        };
+
+        write_raw(out, header);
+        for(T const& symbol: symbols) {
+            write_raw(out, symbol);
+        }
+        write_padding(out, layout.symbols + symbols.size() * sizeof(T));
+
+        for(std::size_t i = 0; i < dfa.state_count(); ++i) {
+            for(T const& symbol: symbols) {
+                write_raw(out, serialize_state(dfa.transition(i, symbol)));
+            }
+            write_raw(out, serialize_state(dfa.unknown_transition(i)));
+        }
+
+        for(std::size_t i = 0; i < dfa.state_count(); ++i) {
+            write_raw(out, static_cast<std::uint8_t>(dfa.is_accepting(i)));
+        }
+        write_padding(out, layout.accepting + dfa.state_count());
+    }
+
+    /**
+     * @brief Writes a set of DFAs in the binary format described in \ref Serialization.hpp.
+     */
+    template<serializable_literal T, input_range_of<DFA<T>> R>
+    void serialize(R&& dfas, std::ostream& out) {
+        std::vector<std::string> blobs;
+        for(DFA<T> const& dfa: dfas) {
+            std::ostringstream blob;
+            serialize(dfa, blob);
+            blobs.push_back(std::move(blob).str());
+        }
+
+        write_raw(out, DFASetHeader{DFA_SET_MAGIC, FORMAT_VERSION, BYTE_ORDER_MARK, 0, blobs.size()});
+        std::uint64_t offset = sizeof(DFASetHeader) + (blobs.size() + 1) * sizeof(std::uint64_t);
+        write_raw(out, offset);
+        for(auto const& blob: blobs) {
+            offset += blob.size();
+            write_raw(out, offset);
+        }
+        for(auto const& blob: blobs) {
+            out.write(blob.data(), blob.size());
+        }
+    }
+
+    /**
+     * @brief Writes a set of DFAs in the binary format described in \ref Serialization.hpp.
+     */
+    template<serializable_literal T>
+    void serialize(std::initializer_list<DFA<T>> dfas, std::ostream& out) {
+        serialize<T>(std::ranges::views::all(dfas), out);
+    }
+
+    /**
+     * @brief Reads a DFA written by \ref serialize().
+     * @exception SerializationException If the input is not a valid serialized DFA over `T`.
+     */
+    template<serializable_literal T>
+    DFA<T> deserialize(std::istream& in) {
+        DFAHeader header;
+        if(!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            throw SerializationException("Truncated header.");
+        }
+        read_header<DFAHeader>(std::as_bytes(std::span(&header, 1)), DFA_MAGIC);
+
+        constexpr std::size_t limit = std::numeric_limits<std::size_t>::max() / 4;
+        if(header.symbols >= limit / sizeof(T) || header.states >= limit / ((header.symbols + 1) * sizeof(std::uint64_t))) {
+            throw SerializationException("Invalid DFA size.");
+        }
+
+        // The sizes are not trusted: the buffer grows as the input is read, rather than being allocated from the header.
+        constexpr std::size_t chunk = std::size_t(1) << 16;
+        DFALayout<T> layout(header.states, header.symbols);
+        std::vector<std::uint64_t> buffer(sizeof(header) / 8);
+        std::memcpy(buffer.data(), &header, sizeof(header));
+        while(buffer.size() < layout.size / 8) {
+            std::size_t read = buffer.size();
+            buffer.resize(std::min(read + chunk, layout.size / 8));
+            if(!in.read(reinterpret_cast<char*>(buffer.data() + read), (buffer.size() - read) * sizeof(std::uint64_t))) {
+                throw SerializationException("Truncated DFA.");
+            }
+        }
+
+        return DFAView<T>(std::as_bytes(std::span(buffer))).to_dfa();
+    }
+    ///@}
+
+    /**
+     * @name Memory-mapping
+     * @brief Maps a file written by \ref serialize() into memory.
+     *
+     * The file is memory-mapped when the platform supports it (and read otherwise),
+     * and stays mapped as long as a view of it exists.
+     *
+     * @exception SerializationException If the file cannot be read or is not valid.
+     * @{
+     */
+    template<serializable_literal T>
+    DFAView<T> map_dfa(std::filesystem::path const& path) {
+        auto file = std::make_shared<MappedFile const>(path);
+        return DFAView<T>(file->bytes(), file);
+    }
+
+    template<serializable_literal T>
+    DFASetView<T> map_dfa_set(std::filesystem::path const& path) {
+        auto file = std::make_shared<MappedFile const>(path);
+        return DFASetView<T>(file->bytes(), file);
+    }
+    ///@}
+
+    namespace {
+        // Structural encoding of a regex (prefix order), used as a cache key.
+        template<typename T>
+        class RegexEncoder final: public matchers::MutableBase<T, void> {
+            using matchers::MutableBase<T, void>::rec;
+
+            std::string& _out;
+
+            void tag(char c) {
+                _out.push_back(c);
+            }
+
+        public:
+            RegexEncoder(std::string& out): _out(out) {}
+
+            void empty() override { tag('0'); }
+            void epsilon() override { tag('e'); }
+            void alphabet() override { tag('S'); }
+            void literal(T const& literal) override {
+                tag('l');
+                _out.append(reinterpret_cast<char const*>(&literal), sizeof(T));
+            }
+            void disjunction(Regex<T> const& left, Regex<T> const& right) override { tag('|'); rec(left); rec(right); }
+            void sequence(Regex<T> const& left, Regex<T> const& right) override { tag('-'); rec(left); rec(right); }
+            void kleene_star(Regex<T> const& regex) override { tag('*'); rec(regex); }
+            void complement(Regex<T> const& regex) override { tag('~'); rec(regex); }
+            void conjunction(Regex<T> const& left, Regex<T> const& right) override { tag('&'); rec(left); rec(right); }
+            void repetition(Regex<T> const& regex, std::size_t min, std::size_t max) override {
+                tag('{');
+                _out.append(reinterpret_cast<char const*>(&min), sizeof(min));
+                _out.append(reinterpret_cast<char const*>(&max), sizeof(max));
+                rec(regex);
+            }
+        };
+
+        inline std::uint64_t fnv1a(std::string const& bytes) {
+            std::uint64_t hash = 0xcbf29ce484222325;
+            for(char c: bytes) {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+            }
+            return hash;
+        }
+    }
+
+    /**
+     * @brief Cache of the DFAs built by \ref make_dfa(Regex<T> const&, DFACache<T>&).
+     *
+     * DFAs are keyed by the structure of their regex: two regexes which are built the same way
+     * share their DFA. The cache is kept in memory and, if a directory is given, on disk
+     * (one file per regex, named after the hash of its structure), so that it can be reused
+     * by other processes.
+     *
+     * @tparam T Type of the alphabet.
+     */
+    template<serializable_literal T>
+    class DFACache final {
+        std::optional<std::filesystem::path> _directory;
+        std::unordered_map<std::string, DFA<T>> _memory;
+
+        std::optional<std::filesystem::path> path_of(std::string const& key) const {
+            if(!_directory.has_value()) {
+                return std::nullopt;
+            }
+
+            std::ostringstream name;
+            name << std::hex << std::setw(16) << std::setfill('0') << fnv1a(key) << ".tfld";
+            return _directory.value() / name.str();
+        }
+
+        // A cached file is made of the (length-prefixed) key, followed by the serialized DFA.
+        std::optional<DFA<T>> load(std::string const& key) const {
+            auto path = path_of(key);
+            if(!path.has_value()) {
+                return std::nullopt;
+            }
+
+            std::ifstream in(path.value(), std::ios::binary);
+            std::uint64_t length;
+            if(!in || !in.read(reinterpret_cast<char*>(&length), sizeof(length)) || length != key.size()) {
+                return std::nullopt;
+            }
+
+            std::string stored(length, '\0');
+            if(!in.read(stored.data(), length) || stored != key) {
+                return std::nullopt;
+            }
+
+            try {
+                return deserialize<T>(in);
+            }
+            catch(SerializationException const&) {
+                return std::nullopt;
+            }
+        }
+
+        void store(std::string const& key, DFA<T> const& dfa) const {
+            auto path = path_of(key);
+            if(!path.has_value()) {
+                return;
+            }
+
+            // Written in a temporary file first, so that concurrent readers never see a partial file.
+            auto tmp = path.value();
+            tmp += ".tmp" + std::to_string(reinterpret_cast<std::uintptr_t>(this));
+            {
+                std::ofstream out(tmp, std::ios::binary);
+                std::uint64_t length = key.size();
+                write_raw(out, length);
+                out.write(key.data(), key.size());
+                serialize(dfa, out);
+            }
+            std::error_code ec;
+            std::filesystem::rename(tmp, path.value(), ec);
+        }
+
+    public:
+        /**
+         * @brief Creates an in-memory cache.
+         */
+        DFACache() = default;
+
+        /**
+         * @brief Creates a cache which is also stored in a directory.
+         * @param directory The directory, created if it does not exist.
+         */
+        DFACache(std::filesystem::path directory): _directory(std::move(directory)) {
+            std::filesystem::create_directories(_directory.value());
+        }
+
+        /**
+         * @brief Returns the DFA associated to the regex, building (and caching) it if needed.
+         */
+        DFA<T> const& get(Regex<T> const& regex) {
+            std::string key;
+            RegexEncoder<T> encoder(key);
+            encoder(regex);
+
+            auto it = _memory.find(key);
+            if(it != _memory.end()) {
+                return it->second;
+            }
+
+            auto dfa = load(key);
+            if(!dfa.has_value()) {
+                dfa = make_dfa(regex);
+                store(key, dfa.value());
+            }
+
+            return _memory.emplace(std::move(key), std::move(dfa.value())).first->second;
+        }
+
+        /**
+         * @brief Returns the number of DFAs held in memory.
+         */
+        std::size_t size() const {
+            return _memory.size();
+        }
+    };
+
+    /**
+     * @brief Converts a regex into an equivalent DFA, using a cache.
+     *
+     * @see \ref make_dfa(Regex<T> const&)
+     */
+    template<serializable_literal T>
+    DFA<T> make_dfa(Regex<T> const& regex, DFACache<T>& cache) {
+        return cache.get(regex);
+    }
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+/**
+ * @brief Contains byte-scanning primitives, vectorized using SSE2/AVX2 when the target supports them.
+ *
+ * The instruction set is selected at compile time (e.g. `-mavx2`), with a scalar fallback.
+ * @file
+ */
+
+namespace tfl {
+
+    /**
+     * @brief Specifies that a type is an integral type whose values are bytes (e.g. `char`).
+     */
+    template<typename T>
+    concept byte_like = std::integral<T> && sizeof(T) == 1;
+
+    /**
+     * @brief A small set of bytes which can be searched for in a byte sequence.
+     */
+    class ByteSet final {
+    public:
+        /** @brief Maximal number of bytes in a set. */
+        static constexpr std::size_t CAPACITY = 8;
+
+    private:
+        std::array<unsigned char, CAPACITY> _bytes{};
+        std::size_t _size = 0;
+
+        // Scalar search of [beg, end[.
+        unsigned char const* find_scalar(unsigned char const* beg, unsigned char const* end) const {
+            for(; beg != end; ++beg) {
+                if(contains(*beg)) {
+                    return beg;
+                }
+            }
+            return end;
+        }
+
+    public:
+        /**
+         * @brief Adds a byte to this set.
+         * @return False if the set is full (in which case the set is not modified).
+         */
+        bool insert(unsigned char byte) {
+            if(contains(byte)) {
+                return true;
+            }
+            if(_size == CAPACITY) {
+                return false;
+            }
+            _bytes[_size++] = byte;
+            return true;
+        }
+
+        /**
+         * @brief Returns the number of bytes in this set.
+         */
+        std::size_t size() const {
+            return _size;
+        }
+
+        /**
+         * @brief Tests whether the byte belongs to this set.
+         */
+        bool contains(unsigned char byte) const {
+            for(std::size_t i = 0; i < _size; ++i) {
+                if(_bytes[i] == byte) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief Finds the first element of [`beg`, `end`[ belonging to this set.
+         * @return A pointer to the element, or `end` if there is none.
+         */
+        template<byte_like T>
+        T const* find(T const* beg, T const* end) const {
+            auto first = reinterpret_cast<unsigned char const*>(beg);
+            auto last = reinterpret_cast<unsigned char const*>(end);
+
+#if defined(__AVX2__)
+            __m256i needles[CAPACITY];
+            for(std::size_t i = 0; i < _size; ++i) {
+                needles[i] = _mm256_set1_epi8(static_cast<char>(_bytes[i]));
+            }
+            for(; last - first >= 32; first += 32) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+                __m256i hits = _mm256_setzero_si256();
+                for(std::size_t i = 0; i < _size; ++i) {
+                    hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, needles[i]));
+                }
+                auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+                if(mask != 0) {
+                    return beg + (first - reinterpret_cast<unsigned char const*>(beg)) + std::countr_zero(mask);
+                }
+            }
+#endif
+#if defined(__SSE2__)
+            __m128i needles128[CAPACITY];
+            for(std::size_t i = 0; i < _size; ++i) {
+                needles128[i] = _mm_set1_epi8(static_cast<char>(_bytes[i]));
+            }
+            for(; last - first >= 16; first += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+                __m128i hits = _mm_setzero_si128();
+                for(std::size_t i = 0; i < _size; ++i) {
+                    hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, needles128[i]));
+                }
+                auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(hits));
+                if(mask != 0) {
+                    return beg + (first - reinterpret_cast<unsigned char const*>(beg)) + std::countr_zero(mask);
+                }
+            }
+#endif
+
+            return beg + (find_scalar(first, last) - reinterpret_cast<unsigned char const*>(beg));
+        }
+    };
+}
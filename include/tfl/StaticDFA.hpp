@@ -0,0 +1,947 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <utility>
+
+#include "Automata.hpp"
+#include "Concepts.hpp"
+
+/**
+ * @brief Contains the compile-time counterparts of \ref tfl::Regex and \ref tfl::DFA.
+ * @file
+ */
+
+namespace tfl {
+
+    /**
+     * @brief Regex which can be built and used in constant expressions.
+     *
+     * This class mirrors \ref Regex (same constructors, same smart-constructors equivalences),
+     * but stores its nodes in a `std::vector` instead of behind `std::shared_ptr`s, which makes it usable
+     * in `constexpr` functions. It is not meant to be stored: it only exists to be transformed
+     * into a \ref StaticDFA by \ref make_static_dfa().
+     *
+     * @tparam T Type of literals.
+     */
+    template<typename T>
+    class StaticRegex final {
+    public:
+        /**
+         * @brief Type of literals (Equivalent to template T)
+         */
+        using TokenType = T;
+
+        /// \private
+        enum class Kind {
+            EMPTY, EPSILON, ALPHABET, LITERAL, DISJUNCTION, SEQUENCE, KLEENE_STAR, COMPLEMENT, CONJUNCTION
+        };
+
+        /// \private
+        struct Node {
+            Kind kind;
+            T lit;
+            std::size_t left;
+            std::size_t right;
+        };
+
+    private:
+        std::vector<Node> _nodes;
+
+        constexpr StaticRegex(Kind kind, T const& lit = T{}): _nodes{Node{kind, lit, 0, 0}} {}
+
+        constexpr StaticRegex(Kind kind, StaticRegex const& left, StaticRegex const& right): _nodes(left._nodes) {
+            std::size_t l = _nodes.size() - 1;
+            std::size_t offset = _nodes.size();
+            for(Node n: right._nodes) {
+                n.left += offset;
+                n.right += offset;
+                _nodes.push_back(n);
+            }
+            _nodes.push_back(Node{kind, T{}, l, _nodes.size() - 1});
+        }
+
+        constexpr StaticRegex(Kind kind, StaticRegex const& underlying): _nodes(underlying._nodes) {
+            _nodes.push_back(Node{kind, T{}, _nodes.size() - 1, _nodes.size() - 1});
+        }
+
+        constexpr Node const& root() const {
+            return _nodes.back();
+        }
+
+        constexpr bool is(Kind kind) const {
+            return root().kind == kind;
+        }
+
+        constexpr bool is_any() const {
+            return (is(Kind::COMPLEMENT) && _nodes[root().left].kind == Kind::EMPTY)
+                || (is(Kind::KLEENE_STAR) && _nodes[root().left].kind == Kind::ALPHABET);
+        }
+
+        constexpr StaticRegex underlying() const {
+            StaticRegex res(*this);
+            res._nodes.pop_back();
+            return res;
+        }
+
+    public:
+        /**
+         * @name Constructors
+         * @see The constructors of \ref Regex with the same name.
+         * @{
+         */
+        static constexpr StaticRegex empty() {
+            return StaticRegex(Kind::EMPTY);
+        }
+
+        static constexpr StaticRegex epsilon() {
+            return StaticRegex(Kind::EPSILON);
+        }
+
+        static constexpr StaticRegex alphabet() {
+            return StaticRegex(Kind::ALPHABET);
+        }
+
+        static constexpr StaticRegex literal(T const& a) {
+            return StaticRegex(Kind::LITERAL, a);
+        }
+
+        constexpr StaticRegex operator|(StaticRegex const& that) const {
+            if(is(Kind::EMPTY) || that.is_any()) {
+                return that;
+            }
+            else if(that.is(Kind::EMPTY) || is_any()) {
+                return *this;
+            }
+            else {
+                return StaticRegex(Kind::DISJUNCTION, *this, that);
+            }
+        }
+
+        constexpr StaticRegex operator-(StaticRegex const& that) const {
+            if(is(Kind::EMPTY) || that.is(Kind::EMPTY)) {
+                return empty();
+            }
+            else if(is(Kind::EPSILON)) {
+                return that;
+            }
+            else if(that.is(Kind::EPSILON)) {
+                return *this;
+            }
+            else {
+                return StaticRegex(Kind::SEQUENCE, *this, that);
+            }
+        }
+
+        constexpr StaticRegex operator*() const {
+            if(is(Kind::KLEENE_STAR)) {
+                return *this;
+            }
+            else if(is(Kind::EMPTY) || is(Kind::EPSILON)) {
+                return epsilon();
+            }
+            else if(is(Kind::ALPHABET)) {
+                return any();
+            }
+            else {
+                return StaticRegex(Kind::KLEENE_STAR, *this);
+            }
+        }
+
+        constexpr StaticRegex operator~() const {
+            if(is(Kind::COMPLEMENT)) {
+                return underlying();
+            }
+            else {
+                return StaticRegex(Kind::COMPLEMENT, *this);
+            }
+        }
+
+        constexpr StaticRegex operator&(StaticRegex const& that) const {
+            if(is(Kind::EMPTY) || that.is(Kind::EMPTY)) {
+                return empty();
+            }
+            else if(is_any()) {
+                return that;
+            }
+            else if(that.is_any()) {
+                return *this;
+            }
+            else {
+                return StaticRegex(Kind::CONJUNCTION, *this, that);
+            }
+        }
+
+        static constexpr StaticRegex any() {
+            return ~empty();
+        }
+
+        constexpr StaticRegex operator+() const {
+            return *this - StaticRegex(Kind::KLEENE_STAR, *this);
+        }
+
+        constexpr StaticRegex operator/(StaticRegex const& that) const {
+            return *this & ~that;
+        }
+        ///@}
+
+        /**
+         * @brief Returns the nodes of this regex; the root is the last node.
+         */
+        constexpr std::vector<Node> const& nodes() const {
+            return _nodes;
+        }
+    };
+
+    /**
+     * @brief "Ghost class" containing functions to build static regexes.
+     *
+     * @see \ref Regexes, which provides the same functions for \ref Regex.
+     *
+     * @tparam T Type of literals.
+     */
+    template<typename T>
+    struct StaticRegexes {
+    protected:
+        StaticRegexes() = default;
+
+    public:
+        static constexpr StaticRegex<T> empty() {
+            return StaticRegex<T>::empty();
+        }
+
+        static constexpr StaticRegex<T> epsilon() {
+            return StaticRegex<T>::epsilon();
+        }
+
+        static constexpr StaticRegex<T> alphabet() {
+            return StaticRegex<T>::alphabet();
+        }
+
+        static constexpr StaticRegex<T> literal(T const& lit) {
+            return StaticRegex<T>::literal(lit);
+        }
+
+        static constexpr StaticRegex<T> any() {
+            return StaticRegex<T>::any();
+        }
+
+        static constexpr StaticRegex<T> opt(StaticRegex<T> const& r) {
+            return epsilon() | r;
+        }
+
+        /**
+         * @brief Makes a regex which only accept the specified sequence.
+         *
+         * @note Use a `std::string_view` rather than a string literal, which would include its null terminator.
+         */
+        template<input_range_of<T> C>
+        static constexpr StaticRegex<T> word(C const& range) {
+            StaticRegex<T> result = epsilon();
+            for(T const& lit : range) {
+                result = result - literal(lit);
+            }
+
+            return result;
+        }
+
+        static constexpr StaticRegex<T> word(std::initializer_list<T> const& range) {
+            return word<std::initializer_list<T>>(range);
+        }
+
+        template<input_range_of<T> C>
+        static constexpr StaticRegex<T> any_of(C const& range) {
+            StaticRegex<T> result = empty();
+            for(T const& lit : range) {
+                result = result | literal(lit);
+            }
+
+            return result;
+        }
+
+        template<input_range_of<StaticRegex<T>> C>
+        static constexpr StaticRegex<T> any_of(C const& range) {
+            StaticRegex<T> result = empty();
+            for(StaticRegex<T> const& regex : range) {
+                result = result | regex;
+            }
+
+            return result;
+        }
+
+        template<typename C>
+        static constexpr StaticRegex<T> any_of(std::initializer_list<C> const& range) {
+            return any_of<std::initializer_list<C>>(range);
+        }
+
+        template<class Eq = std::equal_to<T>, class Less = std::less<T>>
+        static constexpr StaticRegex<T> range(T low, T const& high) {
+            StaticRegex<T> result = empty();
+            for(; Less{}(low, high); ++low) {
+                result = result | literal(low);
+            }
+
+            if(Eq{}(low, high)) {
+                result = result | literal(low);
+            }
+
+            return result;
+        }
+    };
+
+    namespace {
+
+        template<typename T>
+        struct StaticNFA {
+            using StateIdx = std::size_t;
+            static constexpr StateIdx DEAD = std::numeric_limits<StateIdx>::max();
+
+            struct State {
+                std::vector<std::pair<std::size_t, StateIdx>> transitions;
+                std::vector<StateIdx> epsilon_transitions;
+                bool accepting;
+            };
+
+            struct Table {
+                std::size_t classes;
+                std::vector<StateIdx> transitions;
+                std::vector<char> accepting;
+
+                constexpr StateIdx state_count() const {
+                    return accepting.size();
+                }
+            };
+
+            std::size_t classes;
+            std::vector<State> states;
+
+            constexpr StateIdx add_state(bool accepting = false) {
+                states.push_back(State{{}, {}, accepting});
+                return states.size() - 1;
+            }
+
+            constexpr StateIdx meld(StaticNFA const& that) {
+                StateIdx offset = states.size();
+                for(State s: that.states) {
+                    for(auto& t: s.transitions) {
+                        t.second += offset;
+                    }
+                    for(auto& e: s.epsilon_transitions) {
+                        e += offset;
+                    }
+                    states.push_back(s);
+                }
+                return offset;
+            }
+
+            static constexpr StaticNFA from_table(Table const& table) {
+                StaticNFA nfa{table.classes, {}};
+                for(StateIdx i = 0; i < table.state_count(); ++i) {
+                    nfa.add_state(table.accepting[i]);
+                    for(std::size_t c = 0; c < table.classes; ++c) {
+                        StateIdx to = table.transitions[i * table.classes + c];
+                        if(to != DEAD) {
+                            nfa.states[i].transitions.emplace_back(c, to);
+                        }
+                    }
+                }
+                return nfa;
+            }
+
+            constexpr std::vector<std::vector<StateIdx>> epsilon_closures() const {
+                std::vector<std::vector<StateIdx>> closures(states.size());
+                std::vector<char> visited(states.size());
+
+                for(StateIdx i = 0; i < states.size(); ++i) {
+                    std::fill(visited.begin(), visited.end(), false);
+                    std::vector<StateIdx> queue{i};
+                    visited[i] = true;
+                    while(!queue.empty()) {
+                        StateIdx s = queue.back();
+                        queue.pop_back();
+                        closures[i].push_back(s);
+                        for(StateIdx e: states[s].epsilon_transitions) {
+                            if(!visited[e]) {
+                                visited[e] = true;
+                                queue.push_back(e);
+                            }
+                        }
+                    }
+                }
+
+                return closures;
+            }
+
+            constexpr Table determinize() const {
+                auto closures = epsilon_closures();
+                std::vector<char> member(states.size());
+
+                // Returns the (sorted) union of the epsilon-closures of the given states.
+                auto close = [&](std::vector<StateIdx> const& set) {
+                    std::vector<StateIdx> res;
+                    for(StateIdx s: set) {
+                        for(StateIdx c: closures[s]) {
+                            if(!member[c]) {
+                                member[c] = true;
+                                res.push_back(c);
+                            }
+                        }
+                    }
+                    for(StateIdx c: res) {
+                        member[c] = false;
+                    }
+                    std::sort(res.begin(), res.end());
+                    return res;
+                };
+
+                Table table{classes, {}, {}};
+                std::vector<std::vector<StateIdx>> sets{close({0})};
+
+                for(StateIdx current = 0; current < sets.size(); ++current) {
+                    std::vector<std::vector<StateIdx>> next(classes);
+                    bool accepting = false;
+                    for(StateIdx s: sets[current]) {
+                        accepting = accepting || states[s].accepting;
+                        for(auto const& t: states[s].transitions) {
+                            next[t.first].push_back(t.second);
+                        }
+                    }
+                    table.accepting.push_back(accepting);
+
+                    for(auto const& targets: next) {
+                        if(targets.empty()) {
+                            table.transitions.push_back(DEAD);
+                            continue;
+                        }
+
+                        auto closed = close(targets);
+                        auto it = std::find(sets.begin(), sets.end(), closed);
+                        table.transitions.push_back(it - sets.begin());
+                        if(it == sets.end()) {
+                            sets.push_back(std::move(closed));
+                        }
+                    }
+                }
+
+                return table;
+            }
+
+            // Whether this automaton is of the form 0 -[symbols]-> 1 (with 1 accepting), in which case
+            // a disjunction with another such automaton can be built without intermediary states.
+            constexpr bool is_symbol_set() const {
+                return states.size() == 2 && !states[0].accepting && states[1].accepting
+                    && states[0].epsilon_transitions.empty() && states[1].epsilon_transitions.empty()
+                    && states[1].transitions.empty()
+                    && std::ranges::all_of(states[0].transitions, [](auto const& t){ return t.second == 1; });
+            }
+
+            static constexpr StaticNFA empty(std::size_t classes) {
+                StaticNFA nfa{classes, {}};
+                nfa.add_state();
+                return nfa;
+            }
+
+            static constexpr StaticNFA epsilon(std::size_t classes) {
+                StaticNFA nfa{classes, {}};
+                nfa.add_state(true);
+                return nfa;
+            }
+
+            static constexpr StaticNFA alphabet(std::size_t classes) {
+                StaticNFA nfa{classes, {}};
+                nfa.add_state();
+                nfa.add_state(true);
+                for(std::size_t c = 0; c < classes; ++c) {
+                    nfa.states[0].transitions.emplace_back(c, 1);
+                }
+                return nfa;
+            }
+
+            static constexpr StaticNFA literal(std::size_t classes, std::size_t cls) {
+                StaticNFA nfa{classes, {}};
+                nfa.add_state();
+                nfa.add_state(true);
+                nfa.states[0].transitions.emplace_back(cls, 1);
+                return nfa;
+            }
+
+            static constexpr StaticNFA disjunction(StaticNFA const& left, StaticNFA const& right) {
+                if(left.is_symbol_set() && right.is_symbol_set()) {
+                    StaticNFA nfa(left);
+                    for(auto const& t: right.states[0].transitions) {
+                        if(std::ranges::find(nfa.states[0].transitions, t) == nfa.states[0].transitions.end()) {
+                            nfa.states[0].transitions.push_back(t);
+                        }
+                    }
+                    return nfa;
+                }
+
+                StaticNFA nfa{left.classes, {}};
+                nfa.add_state();
+                StateIdx l = nfa.meld(left);
+                StateIdx r = nfa.meld(right);
+                nfa.states[0].epsilon_transitions = {l, r};
+                return nfa;
+            }
+
+            static constexpr StaticNFA sequence(StaticNFA const& left, StaticNFA const& right) {
+                StaticNFA nfa(left);
+                StateIdx r = nfa.meld(right);
+                for(StateIdx i = 0; i < r; ++i) {
+                    if(nfa.states[i].accepting) {
+                        nfa.states[i].accepting = false;
+                        nfa.states[i].epsilon_transitions.push_back(r);
+                    }
+                }
+                return nfa;
+            }
+
+            static constexpr StaticNFA closure(StaticNFA const& underlying) {
+                StaticNFA nfa{underlying.classes, {}};
+                nfa.add_state(true);
+                nfa.meld(underlying);
+                nfa.states[0].epsilon_transitions.push_back(1);
+                for(StateIdx i = 1; i < nfa.states.size(); ++i) {
+                    if(nfa.states[i].accepting) {
+                        nfa.states[i].epsilon_transitions.push_back(0);
+                    }
+                }
+                return nfa;
+            }
+
+            static constexpr StaticNFA complement(StaticNFA const& underlying) {
+                Table table = underlying.determinize();
+                StateIdx live = table.state_count();
+                for(std::size_t c = 0; c < table.classes; ++c) {
+                    table.transitions.push_back(live);
+                }
+                table.accepting.push_back(false);
+
+                for(auto& t: table.transitions) {
+                    if(t == DEAD) {
+                        t = live;
+                    }
+                }
+                for(StateIdx i = 0; i < table.state_count(); ++i) {
+                    table.accepting[i] = !table.accepting[i];
+                }
+
+                return from_table(table);
+            }
+
+            static constexpr StaticNFA conjunction(StaticNFA const& left, StaticNFA const& right) {
+                Table l = left.determinize();
+                Table r = right.determinize();
+                std::size_t classes = l.classes;
+
+                Table table{classes, {}, {}};
+                std::vector<std::pair<StateIdx, StateIdx>> pairs{{0, 0}};
+                for(StateIdx current = 0; current < pairs.size(); ++current) {
+                    auto [lc, rc] = pairs[current];
+                    table.accepting.push_back(l.accepting[lc] && r.accepting[rc]);
+
+                    for(std::size_t c = 0; c < classes; ++c) {
+                        StateIdx lt = l.transitions[lc * classes + c];
+                        StateIdx rt = r.transitions[rc * classes + c];
+                        if(lt == DEAD || rt == DEAD) {
+                            table.transitions.push_back(DEAD);
+                            continue;
+                        }
+
+                        auto it = std::find(pairs.begin(), pairs.end(), std::pair{lt, rt});
+                        table.transitions.push_back(it - pairs.begin());
+                        if(it == pairs.end()) {
+                            pairs.emplace_back(lt, rt);
+                        }
+                    }
+                }
+
+                return from_table(table);
+            }
+
+            static constexpr StaticNFA build(StaticRegex<T> const& regex, std::vector<T> const& symbols, std::size_t idx) {
+                using Kind = typename StaticRegex<T>::Kind;
+                auto const& node = regex.nodes()[idx];
+                std::size_t classes = symbols.size() + 1;
+
+                switch(node.kind) {
+                    case Kind::EMPTY:
+                        return empty(classes);
+                    case Kind::EPSILON:
+                        return epsilon(classes);
+                    case Kind::ALPHABET:
+                        return alphabet(classes);
+                    case Kind::LITERAL:
+                        return literal(classes, std::lower_bound(symbols.begin(), symbols.end(), node.lit) - symbols.begin());
+                    case Kind::DISJUNCTION:
+                        return disjunction(build(regex, symbols, node.left), build(regex, symbols, node.right));
+                    case Kind::SEQUENCE:
+                        return sequence(build(regex, symbols, node.left), build(regex, symbols, node.right));
+                    case Kind::KLEENE_STAR:
+                        return closure(build(regex, symbols, node.left));
+                    case Kind::COMPLEMENT:
+                        return complement(build(regex, symbols, node.left));
+                    case Kind::CONJUNCTION:
+                        return conjunction(build(regex, symbols, node.left), build(regex, symbols, node.right));
+                }
+
+                return empty(classes);
+            }
+        };
+
+        template<typename T>
+        struct StaticConstruction {
+            std::vector<T> symbols;
+            typename StaticNFA<T>::Table table;
+        };
+
+        template<typename T>
+        constexpr StaticConstruction<T> static_construction(StaticRegex<T> const& regex) {
+            using Kind = typename StaticRegex<T>::Kind;
+
+            std::vector<T> symbols;
+            for(auto const& node: regex.nodes()) {
+                if(node.kind == Kind::LITERAL) {
+                    symbols.push_back(node.lit);
+                }
+            }
+            std::sort(symbols.begin(), symbols.end());
+            symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+
+            auto nfa = StaticNFA<T>::build(regex, symbols, regex.nodes().size() - 1);
+            return StaticConstruction<T>{symbols, nfa.determinize()};
+        }
+    }
+
+    /**
+     * @brief Reference to the tables of a \ref StaticDFA, whatever its number of states and symbols.
+     *
+     * Static DFAs have different types, so that they cannot be used as the matchers of the same lexer:
+     * the lexer rules use views instead (see \ref Lexer::make_dfa_lexer()), which are implicitly obtained
+     * from the automata. No table is copied, so the automaton must outlive its views (as `constexpr` ones do).
+     *
+     * A default-constructed view refers to no automaton, and accepts nothing.
+     *
+     * @tparam T Type of the alphabet.
+     */
+    template<typename T>
+    class StaticDFAView final {
+    public:
+        /** @brief Type used to represent states. */
+        using StateIdx = typename DFA<T>::StateIdx;
+
+        /** @brief Index of the dead state. */
+        static constexpr StateIdx const DEAD_STATE = DFA<T>::DEAD_STATE;
+
+    private:
+        T const* _symbols = nullptr;
+        std::size_t _symbol_count = 0;
+        StateIdx const* _transitions = nullptr;
+        bool const* _accepting = nullptr;
+        StateIdx _states = 0;
+        // The class of each byte, if the literals are bytes.
+        std::size_t const* _classes = nullptr;
+
+        constexpr std::size_t symbol_class(T const& x) const {
+            if(_classes) {
+                return _classes[static_cast<unsigned char>(x)];
+            }
+            auto it = std::lower_bound(_symbols, _symbols + _symbol_count, x);
+            return (it != _symbols + _symbol_count && *it == x) ? it - _symbols : _symbol_count;
+        }
+
+        constexpr StateIdx transition_unchecked(StateIdx const& state, T const& x) const {
+            return _transitions[state * (_symbol_count + 1) + symbol_class(x)];
+        }
+
+    public:
+        constexpr StaticDFAView() = default;
+
+        /// \private
+        constexpr StaticDFAView(T const* symbols, std::size_t symbol_count, StateIdx const* transitions, bool const* accepting, StateIdx states, std::size_t const* classes):
+        _symbols(symbols), _symbol_count(symbol_count), _transitions(transitions), _accepting(accepting), _states(states), _classes(classes) {}
+
+        /**
+         * @brief Returns the number of states. The dead state is not counted.
+         */
+        constexpr StateIdx state_count() const {
+            return _states;
+        }
+
+        /**
+         * @brief Tests whether \f$ \textup{state} \in F\f$.
+         */
+        constexpr bool is_accepting(StateIdx const& state) const {
+            return state == DEAD_STATE ? false : _accepting[state];
+        }
+
+        /**
+         * @brief Returns \f$ \delta(\textup{state} \times x) \f$ (\f$ x \f$ might be unknown).
+         */
+        constexpr StateIdx transition(StateIdx const& state, T const& x) const {
+            return state == DEAD_STATE ? DEAD_STATE : transition_unchecked(state, x);
+        }
+
+        /**
+         * @name Language membership
+         * @see The \ref DFA functions with the same name.
+         * @{
+         */
+        template<input_range_of<T> R>
+        constexpr bool accepts(R&& sequence) const noexcept {
+            StateIdx state = _states == 0 ? DEAD_STATE : 0;
+            for(
+                auto beg = std::ranges::cbegin(sequence), end = std::ranges::cend(sequence);
+                (beg != end) && (state != DEAD_STATE);
+                ++beg
+            ) {
+                state = transition_unchecked(state, *beg);
+            }
+
+            return is_accepting(state);
+        }
+
+        template<input_range_of<T> R>
+        constexpr std::optional<std::size_t> munch(R&& sequence) const noexcept {
+            StateIdx state = _states == 0 ? DEAD_STATE : 0;
+            std::size_t step = 0;
+            std::optional<std::size_t> res = is_accepting(state) ?
+                std::optional<std::size_t>{0} :
+                std::optional<std::size_t>{std::nullopt};
+
+            for(
+                auto beg = std::ranges::cbegin(sequence), end = std::ranges::cend(sequence);
+                (beg != end) && (state != DEAD_STATE);
+                ++beg
+            ) {
+                ++step;
+                state = transition_unchecked(state, *beg);
+
+                if(is_accepting(state)) {
+                    res = step;
+                }
+            }
+
+            return res;
+        }
+        ///@}
+    };
+
+    /**
+     * @brief %DFA whose tables are computed at compile time.
+     *
+     * Obtained using \ref make_static_dfa(). This automaton has the same semantics
+     * as a \ref DFA (see the latter for the definitions), but its tables are stored in `std::array`s, so that
+     * a `constexpr` StaticDFA lives in read-only memory and does not require any initialization at runtime.
+     *
+     * The alphabet is split into `Symbols + 1` classes: one for each symbol of \f$ T^{-} \f$, and the
+     * \f$ \textsc{UNKNOWN} \f$ class.
+     *
+     * @tparam T Type of the alphabet. Must be totally ordered.
+     * @tparam States Number of states (the dead state is not counted).
+     * @tparam Symbols Size of \f$ T^{-} \f$.
+     */
+    template<typename T, std::size_t States, std::size_t Symbols>
+    class StaticDFA final {
+    public:
+        /** @brief Type used to represent states. */
+        using StateIdx = typename DFA<T>::StateIdx;
+
+        /** @brief Index of the dead state. */
+        static constexpr StateIdx const DEAD_STATE = DFA<T>::DEAD_STATE;
+
+    private:
+        static constexpr std::size_t CLASSES = Symbols + 1;
+        static constexpr bool BYTE_SIZED = sizeof(T) == 1 && std::integral<T>;
+
+        struct NoClassTable {};
+        using ClassTable = std::conditional_t<BYTE_SIZED, std::array<std::size_t, 256>, NoClassTable>;
+
+        std::array<T, Symbols> _symbols;
+        std::array<StateIdx, States * CLASSES> _transitions;
+        std::array<bool, States> _accepting;
+        [[no_unique_address]] ClassTable _classes;
+
+        constexpr std::size_t symbol_class(T const& x) const {
+            if constexpr(BYTE_SIZED) {
+                return _classes[static_cast<unsigned char>(x)];
+            }
+            else {
+                auto it = std::lower_bound(_symbols.cbegin(), _symbols.cend(), x);
+                return (it != _symbols.cend() && *it == x) ? it - _symbols.cbegin() : Symbols;
+            }
+        }
+
+        constexpr StateIdx transition_unchecked(StateIdx const& state, T const& x) const {
+            return _transitions[state * CLASSES + symbol_class(x)];
+        }
+
+    public:
+        /// \private
+        constexpr StaticDFA(StaticConstruction<T> const& construction): _symbols{}, _transitions{}, _accepting{}, _classes{} {
+            std::copy(construction.symbols.cbegin(), construction.symbols.cend(), _symbols.begin());
+            std::copy(construction.table.transitions.cbegin(), construction.table.transitions.cend(), _transitions.begin());
+            std::copy(construction.table.accepting.cbegin(), construction.table.accepting.cend(), _accepting.begin());
+
+            if constexpr(BYTE_SIZED) {
+                _classes.fill(Symbols);
+                for(std::size_t i = 0; i < Symbols; ++i) {
+                    _classes[static_cast<unsigned char>(_symbols[i])] = i;
+                }
+            }
+        }
+
+        /**
+         * @brief Returns the number of states. The dead state is not counted.
+         */
+        static constexpr StateIdx state_count() {
+            return States;
+        }
+
+        /**
+         * @brief Tests whether \f$ \textup{state} \in F\f$.
+         */
+        constexpr bool is_accepting(StateIdx const& state) const {
+            return state == DEAD_STATE ? false : _accepting[state];
+        }
+
+        /**
+         * @brief Returns \f$ \delta(\textup{state} \times x) \f$ (\f$ x \f$ might be unknown).
+         */
+        constexpr StateIdx transition(StateIdx const& state, T const& x) const {
+            return state == DEAD_STATE ? DEAD_STATE : transition_unchecked(state, x);
+        }
+
+        /**
+         * @brief Returns \f$ T^{-} \f$.
+         */
+        constexpr std::array<T, Symbols> const& alphabet() const {
+            return _symbols;
+        }
+
+        /**
+         * @name Language membership
+         * @see The \ref DFA functions with the same name.
+         * @{
+         */
+        template<input_range_of<T> R>
+        constexpr bool accepts(R&& sequence) const noexcept {
+            StateIdx state = 0;
+            for(
+                auto beg = std::ranges::cbegin(sequence), end = std::ranges::cend(sequence);
+                (beg != end) && (state != DEAD_STATE);
+                ++beg
+            ) {
+                state = transition_unchecked(state, *beg);
+            }
+
+            return is_accepting(state);
+        }
+
+        constexpr bool accepts(std::initializer_list<T> sequence) const noexcept {
+            return accepts(std::ranges::views::all(sequence));
+        }
+
+        template<input_range_of<T> R>
+        constexpr std::optional<std::size_t> munch(R&& sequence) const noexcept {
+            StateIdx state = 0;
+            std::size_t step = 0;
+            std::optional<std::size_t> res = is_accepting(state) ?
+                std::optional<std::size_t>{0} :
+                std::optional<std::size_t>{std::nullopt};
+
+            for(
+                auto beg = std::ranges::cbegin(sequence), end = std::ranges::cend(sequence);
+                (beg != end) && (state != DEAD_STATE);
+                ++beg
+            ) {
+                ++step;
+                state = transition_unchecked(state, *beg);
+
+                if(is_accepting(state)) {
+                    res = step;
+                }
+            }
+
+            return res;
+        }
+
+        constexpr std::optional<std::size_t> munch(std::initializer_list<T> sequence) const noexcept {
+            return munch(std::ranges::views::all(sequence));
+        }
+        ///@}
+
+        /**
+         * @brief Returns a view of the tables of this automaton, which must outlive it.
+         */
+        constexpr StaticDFAView<T> view() const {
+            std::size_t const* classes = nullptr;
+            if constexpr(BYTE_SIZED) {
+                classes = _classes.data();
+            }
+            return StaticDFAView<T>(_symbols.data(), Symbols, _transitions.data(), _accepting.data(), States, classes);
+        }
+
+        /**
+         * @brief Converts this automaton into a view of its tables (see \ref view()).
+         */
+        constexpr operator StaticDFAView<T>() const {
+            return view();
+        }
+
+        /**
+         * @brief Converts this automaton into an equivalent (runtime) \ref DFA.
+         */
+        DFA<T> to_dfa() const {
+            typename DFA<T>::Builder builder(_symbols, States);
+
+            for(StateIdx i = 0; i < States; ++i) {
+                for(std::size_t c = 0; c < Symbols; ++c) {
+                    builder.set_transition(i, _symbols[c], _transitions[i * CLASSES + c]);
+                }
+                builder.set_unknown_transition(i, _transitions[i * CLASSES + Symbols]);
+                builder.set_acceptance(i, _accepting[i]);
+            }
+
+            return builder;
+        }
+    };
+
+    /**
+     * @brief Converts a static regex into an equivalent DFA at compile time.
+     *
+     * The regex is given as a (captureless) function-object returning a \ref StaticRegex,
+     * typically a lambda:
+     * \code{.cpp}
+     * constexpr auto number = tfl::make_static_dfa<[]{
+     *     using R = tfl::StaticRegexes<char>;
+     *     auto digit = R::range('0', '9');
+     *     return digit - *digit;
+     * }>();
+     * static_assert(number.accepts(std::string_view("42")));
+     * \endcode
+     *
+     * The construction (Thompson construction followed by subset construction) is performed during
+     * constant evaluation, so that the resulting automaton has no startup cost.
+     *
+     * @tparam Spec Function-object returning the regex.
+     */
+    template<auto Spec>
+    constexpr auto make_static_dfa() {
+        using T = typename decltype(Spec())::TokenType;
+
+        // Allocations cannot outlive constant evaluation, so the sizes are computed beforehand.
+        constexpr auto sizes = []{
+            auto construction = static_construction(Spec());
+            return std::pair{construction.table.state_count(), construction.symbols.size()};
+        }();
+
+        return StaticDFA<T, sizes.first, sizes.second>(static_construction(Spec()));
+    }
+}
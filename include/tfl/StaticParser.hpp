@@ -0,0 +1,402 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <concepts>
+#include <iterator>
+#include <initializer_list>
+
+#include "Parser.hpp"
+#include "Concepts.hpp"
+
+/**
+ * @brief Contains statically dispatched parser combinators.
+ * @file
+ */
+
+namespace tfl {
+
+    template<typename, typename, typename> class StaticParser;
+
+    /**
+     * @brief Specifies that a type is a statically dispatched parser (i.e. derives from \ref StaticParser).
+     *
+     * @tparam P The parser type.
+     */
+    template<typename P>
+    concept static_parser = std::derived_from<P, StaticParser<P, typename P::TokenType, typename P::ValueType>>;
+
+    /**
+     * @brief Contains the expression types built by the \ref StaticParser combinators.
+     *
+     * Those types are not meant to be named directly: they are obtained by combining
+     * the parsers returned by \ref StaticParsers, and should be stored using `auto`.
+     */
+    class StaticParserImpl {
+        StaticParserImpl() = delete;
+
+        template<typename, typename, typename> friend class StaticParser;
+
+        template<static_parser P>
+        class Adapter final: public ParserImpl::ParserBase<typename P::TokenType, typename P::ValueType> {
+            P const _underlying;
+
+        public:
+            using Result = typename ParserImpl::ParserBase<typename P::TokenType, typename P::ValueType>::Result;
+            using It = typename ParserImpl::ParserBase<typename P::TokenType, typename P::ValueType>::It;
+
+            Adapter(P const& underlying): _underlying(underlying) {}
+
+            virtual Result apply(It const& beg, It const& end) const {
+                return _underlying.apply(beg, end);
+            }
+        };
+
+        template<static_parser P>
+        static Parser<typename P::TokenType, typename P::ValueType> erase(P const& parser) {
+            using T = typename P::TokenType;
+            using R = typename P::ValueType;
+            return Parser<T, R>(static_cast<ParserImpl::ParserBase<T, R>*>(new Adapter<P>(parser)));
+        }
+
+    public:
+        template<typename T, std::predicate<T> F>
+        class Elem final: public StaticParser<Elem<T, F>, T, T> {
+            F const _pred;
+
+        public:
+            using Result = typename StaticParser<Elem, T, T>::Result;
+            using It = typename StaticParser<Elem, T, T>::It;
+
+            Elem(F const& predicate): _pred(predicate) {}
+
+            Result apply(It const& beg, It const& end) const {
+                if(auto* memo = ParserImpl::Memo<T>::active) {
+                    memo->read(beg);
+                }
+                return (beg != end && _pred(*beg)) ? Result{{*beg, beg+1}} : Result{};
+            }
+        };
+
+        template<typename T, typename R>
+        class Epsilon final: public StaticParser<Epsilon<T, R>, T, R> {
+            R const _val;
+
+        public:
+            using Result = typename StaticParser<Epsilon, T, R>::Result;
+            using It = typename StaticParser<Epsilon, T, R>::It;
+
+            Epsilon(R const& val): _val(val) {}
+
+            Result apply(It const& beg, It const&) const {
+                return Result{{_val, beg}};
+            }
+        };
+
+        template<static_parser L, static_parser Rp>
+        requires std::same_as<typename L::TokenType, typename Rp::TokenType> && std::same_as<typename L::ValueType, typename Rp::ValueType>
+        class Disjunction final: public StaticParser<Disjunction<L, Rp>, typename L::TokenType, typename L::ValueType> {
+            L const _left;
+            Rp const _right;
+
+        public:
+            using Result = typename StaticParser<Disjunction, typename L::TokenType, typename L::ValueType>::Result;
+            using It = typename StaticParser<Disjunction, typename L::TokenType, typename L::ValueType>::It;
+
+            Disjunction(L const& left, Rp const& right): _left(left), _right(right) {}
+
+            Result apply(It const& beg, It const& end) const {
+                Result l(_left.apply(beg, end));
+                Result r(_right.apply(beg, end));
+                l.reserve(l.size() + r.size());
+                l.insert(l.end(), r.begin(), r.end());
+                return l;
+            }
+        };
+
+        template<static_parser L, static_parser Rp>
+        requires std::same_as<typename L::TokenType, typename Rp::TokenType>
+        class Sequence final: public StaticParser<
+            Sequence<L, Rp>,
+            typename L::TokenType,
+            std::pair<typename L::ValueType, typename Rp::ValueType>
+        > {
+            using R = std::pair<typename L::ValueType, typename Rp::ValueType>;
+            L const _left;
+            Rp const _right;
+
+        public:
+            using Result = typename StaticParser<Sequence, typename L::TokenType, R>::Result;
+            using It = typename StaticParser<Sequence, typename L::TokenType, R>::It;
+
+            Sequence(L const& left, Rp const& right): _left(left), _right(right) {}
+
+            Result apply(It const& beg, It const& end) const {
+                Result res;
+                auto l(_left.apply(beg, end));
+
+                for(auto& p : l) {
+                    auto follow(_right.apply(p.second, end));
+
+                    res.reserve(res.size() + follow.size());
+                    for(auto& f : follow) {
+                        res.emplace_back(R{p.first, f.first}, f.second);
+                    }
+                }
+
+                return res;
+            }
+        };
+
+        template<static_parser P, std::invocable<typename P::ValueType> F>
+        class Map final: public StaticParser<
+            Map<P, F>,
+            typename P::TokenType,
+            std::invoke_result_t<F, typename P::ValueType>
+        > {
+            using R = std::invoke_result_t<F, typename P::ValueType>;
+            P const _underlying;
+            F const _map;
+
+        public:
+            using Result = typename StaticParser<Map, typename P::TokenType, R>::Result;
+            using It = typename StaticParser<Map, typename P::TokenType, R>::It;
+
+            Map(P const& underlying, F const& map): _underlying(underlying), _map(map) {}
+
+            Result apply(It const& beg, It const& end) const {
+                Result res;
+                auto sub(_underlying.apply(beg, end));
+                res.reserve(sub.size());
+
+                for(auto& p : sub) {
+                    res.emplace_back(_map(p.first), p.second);
+                }
+
+                return res;
+            }
+        };
+
+        template<typename T, typename R>
+        class Erased final: public StaticParser<Erased<T, R>, T, R> {
+            Parser<T, R> const _parser;
+
+        public:
+            using Result = typename StaticParser<Erased, T, R>::Result;
+            using It = typename StaticParser<Erased, T, R>::It;
+
+            Erased(Parser<T, R> const& parser): _parser(parser) {}
+
+            Result apply(It const& beg, It const& end) const {
+                return _parser.apply(beg, end);
+            }
+        };
+    };
+
+    /**
+     * @brief %Base of statically dispatched parsers.
+     *
+     * Contrary to \ref Parser, whose combinators are type-erased (and thus opaque to the compiler),
+     * combining statically dispatched parsers builds a type mirroring the grammar
+     * (an <a href="https://en.wikipedia.org/wiki/Expression_templates">expression template</a>),
+     * which allows the whole parse to be inlined.
+     *
+     * Type erasure is only required for recursive grammars: a \ref Parser or \ref Recursive can
+     * be embedded using \ref StaticParsers::lift() (or implicitly, when combined with a static parser),
+     * and any static parser converts into a \ref Parser.
+     *
+     * @tparam D The derived parser type (see <a href="https://en.wikipedia.org/wiki/Curiously_recurring_template_pattern">CRTP</a>).
+     * @tparam T The token type.
+     * @tparam R The value type.
+     */
+    template<typename D, typename T, typename R>
+    class StaticParser {
+    protected:
+        StaticParser() = default;
+
+        D const& derived() const {
+            return static_cast<D const&>(*this);
+        }
+
+    public:
+        using TokenType = T;
+        using ValueType = R;
+        using It = typename std::vector<T>::const_iterator;
+        using Result = std::vector<std::pair<R, It>>;
+
+        /**
+         * @brief Parses the whole input; see \ref Parser::operator()().
+         * @throws ParsingException If there isn't exactly one way to parse the input.
+         */
+        template<std::input_iterator Iter>
+        R operator()(Iter const& beg, Iter const& end) const {
+            auto r = parse_all(beg, end);
+
+            if(r.size() != 1) {
+                throw ParsingException("Parsing failed: " + std::to_string(r.size()) + " match(es).");
+            }
+            else {
+                return r[0];
+            }
+        }
+
+        R operator()(std::initializer_list<T> ls) const {
+            return operator()(ls.begin(), ls.end());
+        }
+
+        /**
+         * @brief Returns all the ways to parse the whole input.
+         */
+        template<std::input_iterator Iter>
+        std::vector<R> parse_all(Iter const& beg, Iter const& end) const {
+            std::vector<T> in(beg, end);
+            Result p{derived().apply(in.cbegin(), in.cend())};
+
+            std::vector<R> res;
+            for(auto& r : p) {
+                if(r.second == in.cend()) {
+                    res.push_back(r.first);
+                }
+            }
+
+            return res;
+        }
+
+        std::vector<R> parse_all(std::initializer_list<T> ls) const {
+            return parse_all(ls.begin(), ls.end());
+        }
+
+        /**
+         * @brief Applies a function to the parsed values.
+         */
+        template<std::invocable<R> F>
+        StaticParserImpl::Map<D, std::decay_t<F>> map(F&& map) const {
+            return StaticParserImpl::Map<D, std::decay_t<F>>(derived(), std::forward<F>(map));
+        }
+
+        /**
+         * @brief Converts this parser into a (type-erased) \ref Parser.
+         */
+        Parser<T, R> erase() const {
+            return StaticParserImpl::erase(derived());
+        }
+
+        /**
+         * @brief See \ref erase().
+         */
+        operator Parser<T, R>() const {
+            return erase();
+        }
+    };
+
+    /**
+     * @name Static parsers combinators
+     * @brief Combinators with the same semantics as their \ref Parser counterparts.
+     *
+     * When combined with a static parser, a \ref Parser (or \ref Recursive) is wrapped
+     * into a type-erased leaf.
+     * @{
+     */
+
+    template<static_parser L, static_parser Rp>
+    requires std::same_as<typename L::TokenType, typename Rp::TokenType> && std::same_as<typename L::ValueType, typename Rp::ValueType>
+    StaticParserImpl::Disjunction<L, Rp> operator|(L const& left, Rp const& right) {
+        return StaticParserImpl::Disjunction<L, Rp>(left, right);
+    }
+
+    template<static_parser L>
+    auto operator|(L const& left, Parser<typename L::TokenType, typename L::ValueType> const& right) {
+        return left | StaticParserImpl::Erased<typename L::TokenType, typename L::ValueType>(right);
+    }
+
+    template<static_parser Rp>
+    auto operator|(Parser<typename Rp::TokenType, typename Rp::ValueType> const& left, Rp const& right) {
+        return StaticParserImpl::Erased<typename Rp::TokenType, typename Rp::ValueType>(left) | right;
+    }
+
+    template<static_parser Rp>
+    auto operator|(Recursive<typename Rp::TokenType, typename Rp::ValueType> const& left, Rp const& right) {
+        return static_cast<Parser<typename Rp::TokenType, typename Rp::ValueType>>(left) | right;
+    }
+
+    template<static_parser L, static_parser Rp>
+    requires std::same_as<typename L::TokenType, typename Rp::TokenType>
+    StaticParserImpl::Sequence<L, Rp> operator&(L const& left, Rp const& right) {
+        return StaticParserImpl::Sequence<L, Rp>(left, right);
+    }
+
+    template<static_parser L, typename R>
+    auto operator&(L const& left, Parser<typename L::TokenType, R> const& right) {
+        return left & StaticParserImpl::Erased<typename L::TokenType, R>(right);
+    }
+
+    template<static_parser L, typename R>
+    auto operator&(L const& left, Recursive<typename L::TokenType, R> const& right) {
+        return left & static_cast<Parser<typename L::TokenType, R>>(right);
+    }
+
+    template<typename R, static_parser Rp>
+    auto operator&(Parser<typename Rp::TokenType, R> const& left, Rp const& right) {
+        return StaticParserImpl::Erased<typename Rp::TokenType, R>(left) & right;
+    }
+
+    template<typename R, static_parser Rp>
+    auto operator&(Recursive<typename Rp::TokenType, R> const& left, Rp const& right) {
+        return static_cast<Parser<typename Rp::TokenType, R>>(left) & right;
+    }
+    ///@}
+
+    /**
+     * @brief "Ghost class" containing functions to build static parsers.
+     *
+     * This class is meant to be privately inherited to bring all
+     * functions into scope.
+     *
+     * @tparam T Type of tokens.
+     */
+    template<typename T>
+    struct StaticParsers {
+    protected:
+        StaticParsers() = default;
+
+    public:
+        template<std::predicate<T> F>
+        static StaticParserImpl::Elem<T, std::decay_t<F>> elem(F&& predicate) {
+            return StaticParserImpl::Elem<T, std::decay_t<F>>(std::forward<F>(predicate));
+        }
+
+        static auto elem(T const& val) {
+            return elem([val](T const& i){ return i == val; });
+        }
+
+        static auto any() {
+            return elem([](T const&){ return true; });
+        }
+
+        static auto none() {
+            return elem([](T const&){ return false; });
+        }
+
+        template<typename R>
+        static StaticParserImpl::Epsilon<T, R> eps(R const& val) {
+            return StaticParserImpl::Epsilon<T, R>(val);
+        }
+
+        /**
+         * @brief Embeds a type-erased parser.
+         */
+        template<typename R>
+        static StaticParserImpl::Erased<T, R> lift(Parser<T, R> const& parser) {
+            return StaticParserImpl::Erased<T, R>(parser);
+        }
+
+        /**
+         * @brief Embeds a recursive parser; this is the only way to write a recursive static grammar.
+         */
+        template<typename R>
+        static StaticParserImpl::Erased<T, R> lift(Recursive<T, R> const& parser) {
+            return StaticParserImpl::Erased<T, R>(static_cast<Parser<T, R>>(parser));
+        }
+    };
+}
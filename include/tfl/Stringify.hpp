@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <iomanip>
 #include <string>
 #include <sstream>
 
@@ -32,9 +34,10 @@ namespace tfl {
      * @brief Specialization of \ref Stringify for integral types for which std defines `to_string`.
      *
      * The types for which this specialization is enable are:
-     * `int, long, long long, unsigned, unsigned long, unsigned long long, float, double, long double`
+     * `int, long, long long, unsigned, unsigned long, unsigned long long, float, double, long double`,
+     * as well as `unsigned char` (bytes), which is written as a number.
      */
-    template<typename Integral> requires is_among_v<std::remove_cv_t<std::remove_reference_t<Integral>>, int, long, long long, unsigned, unsigned long, unsigned long long, float, double, long double>
+    template<typename Integral> requires is_among_v<std::remove_cv_t<std::remove_reference_t<Integral>>, int, long, long long, unsigned char, unsigned, unsigned long, unsigned long long, float, double, long double>
     struct Stringify<Integral> final {
         static std::string convert(Integral const& i) {
             return std::to_string(i);
@@ -71,4 +74,16 @@ namespace tfl {
         }
     };
 
+    /**
+     * @brief Specialization of \ref Stringify for `char32_t`, written as a Unicode code point (e.g. `U+20AC`).
+     */
+    template<>
+    struct Stringify<char32_t> final {
+        static std::string convert(char32_t const& c) {
+            std::ostringstream out;
+            out << "U+" << std::uppercase << std::hex << std::setw(4) << std::setfill('0') << static_cast<std::uint32_t>(c);
+            return out.str();
+        }
+    };
+
 }
\ No newline at end of file
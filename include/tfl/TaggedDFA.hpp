@@ -0,0 +1,551 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Automata.hpp"
+#include "AutomataOps.hpp"
+#include "Regex.hpp"
+#include "RegexOps.hpp"
+
+/**
+ * @brief Contains the definition of tagged DFAs, which extract submatches.
+ * @file
+ */
+
+namespace tfl {
+
+    /**
+     * @brief The longest prefix matched by a \ref TaggedDFA, and the subsequences captured within it.
+     */
+    struct Submatches final {
+        /**
+         * @brief Length of the prefix.
+         */
+        std::size_t length;
+
+        /**
+         * @brief For each group, the captured subsequence (relative to the start of the prefix), if any.
+         */
+        std::vector<std::optional<Match>> groups;
+
+        bool operator==(Submatches const&) const = default;
+    };
+
+    namespace matchers {
+
+        namespace {
+
+            template<typename T>
+            class CaptureFinder final: public Base<T, bool> {
+                using Base<T, bool>::rec;
+            public:
+                bool empty() const { return false; }
+                bool epsilon() const { return false; }
+                bool alphabet() const { return false; }
+                bool literal(T const&) const { return false; }
+                bool disjunction(Regex<T> const& left, Regex<T> const& right) const { return rec(left) || rec(right); }
+                bool sequence(Regex<T> const& left, Regex<T> const& right) const { return rec(left) || rec(right); }
+                bool kleene_star(Regex<T> const& regex) const { return rec(regex); }
+                bool complement(Regex<T> const& regex) const { return rec(regex); }
+                bool conjunction(Regex<T> const& left, Regex<T> const& right) const { return rec(left) || rec(right); }
+                bool capture(std::size_t, Regex<T> const&) const { return true; }
+            };
+            template<typename T> constexpr CaptureFinder<T> capture_finder{};
+        }
+    }
+
+    namespace {
+
+        // NFA whose ε-transitions are ordered by priority, and can set tags
+        // (tags 2k and 2k+1 being the start and the end of group k).
+        template<typename T>
+        struct TaggedNFA final {
+            using StateIdx = std::size_t;
+            static constexpr StateIdx NONE = std::numeric_limits<StateIdx>::max();
+
+            struct State {
+                // Transitions on literals (possibly to NONE), the other literals use the unknown transition.
+                std::unordered_map<T, StateIdx> transitions;
+                std::optional<StateIdx> unknown;
+                std::vector<std::pair<StateIdx, std::optional<std::size_t>>> epsilons;
+            };
+
+            std::vector<State> states;
+
+            StateIdx add_state() {
+                states.emplace_back();
+                return states.size() - 1;
+            }
+
+            void add_epsilon(StateIdx from, StateIdx to, std::optional<std::size_t> tag = std::nullopt) {
+                states[from].epsilons.emplace_back(to, tag);
+            }
+
+            bool has_moves(StateIdx state) const {
+                return !states[state].transitions.empty() || states[state].unknown.has_value();
+            }
+
+            std::optional<StateIdx> move(StateIdx state, std::optional<T> const& input) const {
+                if(input.has_value()) {
+                    auto it = states[state].transitions.find(*input);
+                    if(it != states[state].transitions.cend()) {
+                        return (it->second == NONE) ? std::nullopt : std::optional{it->second};
+                    }
+                }
+                return states[state].unknown;
+            }
+        };
+
+        // Builds the fragment (entry and exit states) of a tagged NFA recognizing a regex.
+        template<typename T>
+        class TaggedNFABuilder final: public matchers::MutableBase<T, std::pair<std::size_t, std::size_t>> {
+            using Fragment = std::pair<std::size_t, std::size_t>;
+
+            TaggedNFA<T>& _nfa;
+            std::size_t _groups = 0;
+
+            // Capture-free regexes (which may use any operator) are converted into a DFA, embedded into the NFA.
+            // Staying in the DFA has priority over leaving it, so that captures are greedy.
+            Fragment embed(Regex<T> const& regex) {
+                DFA<T> dfa = make_dfa(regex);
+                std::size_t offset = _nfa.states.size();
+                for(std::size_t i = 0; i < dfa.state_count(); ++i) {
+                    _nfa.add_state();
+                }
+                std::size_t exit = _nfa.add_state();
+
+                auto map = [offset](std::size_t state){ return (state == DFA<T>::DEAD_STATE) ? TaggedNFA<T>::NONE : state + offset; };
+                for(std::size_t i = 0; i < dfa.state_count(); ++i) {
+                    auto& state = _nfa.states[offset + i];
+                    for(auto input: dfa.alphabet()) {
+                        state.transitions.emplace(input, map(dfa.transition(i, input)));
+                    }
+                    if(dfa.unknown_transition(i) != DFA<T>::DEAD_STATE) {
+                        state.unknown = map(dfa.unknown_transition(i));
+                    }
+                    if(dfa.is_accepting(i)) {
+                        _nfa.add_epsilon(offset + i, exit);
+                    }
+                }
+
+                return {offset, exit};
+            }
+
+        public:
+            TaggedNFABuilder(TaggedNFA<T>& nfa): _nfa(nfa) {}
+
+            Fragment build(Regex<T> const& regex) {
+                if(!regex.match(matchers::capture_finder<T>)) {
+                    return embed(regex);
+                }
+                return (*this)(regex);
+            }
+
+            std::size_t group_count() const {
+                return _groups;
+            }
+
+            Fragment empty() { return embed(Regex<T>::empty()); }
+            Fragment epsilon() { return embed(Regex<T>::epsilon()); }
+            Fragment alphabet() { return embed(Regex<T>::alphabet()); }
+            Fragment literal(T const& literal) { return embed(Regex<T>::literal(literal)); }
+            Fragment disjunction(Regex<T> const& left, Regex<T> const& right) {
+                auto [lentry, lexit] = build(left);
+                auto [rentry, rexit] = build(right);
+                std::size_t entry = _nfa.add_state();
+                std::size_t exit = _nfa.add_state();
+                _nfa.add_epsilon(entry, lentry);
+                _nfa.add_epsilon(entry, rentry);
+                _nfa.add_epsilon(lexit, exit);
+                _nfa.add_epsilon(rexit, exit);
+                return {entry, exit};
+            }
+            Fragment sequence(Regex<T> const& left, Regex<T> const& right) {
+                auto [lentry, lexit] = build(left);
+                auto [rentry, rexit] = build(right);
+                _nfa.add_epsilon(lexit, rentry);
+                return {lentry, rexit};
+            }
+            Fragment kleene_star(Regex<T> const& regex) {
+                std::size_t entry = _nfa.add_state();
+                auto [sentry, sexit] = build(regex);
+                std::size_t exit = _nfa.add_state();
+                _nfa.add_epsilon(entry, sentry);
+                _nfa.add_epsilon(entry, exit);
+                _nfa.add_epsilon(sexit, entry);
+                return {entry, exit};
+            }
+            Fragment complement(Regex<T> const&) {
+                throw std::invalid_argument("Captures are not supported within complements.");
+            }
+            Fragment conjunction(Regex<T> const&, Regex<T> const&) {
+                throw std::invalid_argument("Captures are not supported within conjunctions.");
+            }
+            Fragment capture(std::size_t group, Regex<T> const& regex) {
+                _groups = std::max(_groups, group + 1);
+                std::size_t entry = _nfa.add_state();
+                auto [sentry, sexit] = build(regex);
+                std::size_t exit = _nfa.add_state();
+                _nfa.add_epsilon(entry, sentry, 2 * group);
+                _nfa.add_epsilon(sexit, exit, 2 * group + 1);
+                return {entry, exit};
+            }
+        };
+    }
+
+    /**
+     * @brief A DFA reporting the subsequences captured by the groups of a regex (see \ref Regex::capture()).
+     *
+     * This is a <a href="https://laurikari.net/ville/spire2000-tnfa.pdf">tagged DFA</a>: each group is delimited by two tags
+     * (its start and its end), whose positions are stored in registers. The transitions update these registers, so that
+     * the submatches are known after a single pass over the input, without any backtracking.
+     *
+     * The tagged DFA is built by determinizing a tagged NFA, in which the capture-free parts of the regex
+     * are embedded as DFAs (which allows complements and conjunctions to be used outside of captures).
+     *
+     * When several paths match the longest prefix, the submatches follow the leftmost-greedy policy:
+     * the left operand of a disjunction is preferred, Kleene stars iterate as much as possible,
+     * and the subsequences captured first are as long as possible.
+     * Within a Kleene star, the last iteration is captured.
+     *
+     * @tparam T Type of the alphabet.
+     */
+    template<typename T>
+    class TaggedDFA final {
+    public:
+        /**
+         * @brief Type used to represent states.
+         * @hideinitializer
+         */
+        using StateIdx = std::size_t;
+
+        /**
+         * @brief Index of the dead state.
+         * @hideinitializer
+         */
+        static constexpr StateIdx const DEAD_STATE = std::numeric_limits<StateIdx>::max();
+
+    private:
+        using RegIdx = std::size_t;
+        static constexpr RegIdx NO_REGISTER = std::numeric_limits<RegIdx>::max();
+        static constexpr std::size_t NO_POSITION = std::numeric_limits<std::size_t>::max();
+
+        // Sets register `first` to the value of register `second`, or to the current position if it is NO_REGISTER.
+        // The commands of a transition are executed simultaneously.
+        using Command = std::pair<RegIdx, RegIdx>;
+
+        struct Edge {
+            StateIdx to;
+            std::vector<Command> commands;
+        };
+
+        // The literals of the regex, mapped to their index in the edges (the index 0 being UNKNOWN).
+        std::unordered_map<T, std::size_t> _classes;
+        std::vector<std::vector<Edge>> _edges;
+        // For each accepting state, the register holding each tag.
+        std::vector<std::optional<std::vector<RegIdx>>> _finals;
+        std::vector<Command> _initial;
+        std::size_t _registers = 0;
+        std::size_t _groups = 0;
+
+        std::vector<Edge> const& edges(T const& x) const {
+            auto it = _classes.find(x);
+            return _edges[(it != _classes.cend()) ? it->second : 0];
+        }
+
+    public:
+        /**
+         * @brief Builds the tagged DFA of a regex.
+         *
+         * @exception std::invalid_argument If a capture appears within a complement or a conjunction.
+         */
+        explicit TaggedDFA(Regex<T> const& regex) {
+            using Config = std::pair<std::size_t, std::vector<RegIdx>>;
+            using Kernel = std::vector<Config>;
+            static constexpr RegIdx CURRENT = NO_REGISTER - 1;
+
+            TaggedNFA<T> nfa;
+            TaggedNFABuilder<T> builder(nfa);
+            auto [entry, exit] = builder.build(regex);
+            _groups = builder.group_count();
+            std::size_t tags = 2 * _groups;
+
+            std::vector<std::optional<T>> inputs{std::nullopt};
+            for(auto const& literal: generate_minimal_alphabet(regex)) {
+                _classes.emplace(literal, inputs.size());
+                inputs.emplace_back(literal);
+            }
+            _edges.resize(inputs.size());
+
+            // Follows the ε-transitions by priority; the tags set along the way are marked as CURRENT.
+            // Only the states with transitions, and the exit, are kept.
+            auto closure = [&nfa, exit](Kernel const& seeds) {
+                Kernel result;
+                std::vector<bool> visited(nfa.states.size(), false);
+                std::function<void(std::size_t, std::vector<RegIdx> const&)> visit = [&](std::size_t state, std::vector<RegIdx> const& regs) {
+                    if(visited[state]) {
+                        return;
+                    }
+                    visited[state] = true;
+                    if(nfa.has_moves(state) || state == exit) {
+                        result.emplace_back(state, regs);
+                    }
+                    for(auto const& [to, tag]: nfa.states[state].epsilons) {
+                        if(tag.has_value()) {
+                            auto next = regs;
+                            next[*tag] = CURRENT;
+                            visit(to, next);
+                        }
+                        else {
+                            visit(to, regs);
+                        }
+                    }
+                };
+
+                for(auto const& [state, regs]: seeds) {
+                    visit(state, regs);
+                }
+                return result;
+            };
+
+            std::vector<Kernel> kernels;
+            std::map<std::vector<std::size_t>, std::vector<StateIdx>> by_states;
+            std::queue<StateIdx> queue;
+
+            // Finds a state equal to the kernel up to a renaming of the registers, or adds it.
+            // Returns the state, and the commands setting its registers.
+            auto intern = [&](Kernel kernel) -> std::pair<StateIdx, std::vector<Command>> {
+                RegIdx first_fresh = _registers;
+                std::vector<RegIdx> fresh(tags, NO_REGISTER);
+                std::vector<std::size_t> key;
+                for(auto& [state, regs]: kernel) {
+                    key.push_back(state);
+                    for(std::size_t t = 0; t < tags; ++t) {
+                        if(regs[t] == CURRENT) {
+                            if(fresh[t] == NO_REGISTER) {
+                                fresh[t] = _registers++;
+                            }
+                            regs[t] = fresh[t];
+                        }
+                    }
+                }
+
+                for(StateIdx candidate: by_states[key]) {
+                    std::map<RegIdx, RegIdx> forward;
+                    std::map<RegIdx, RegIdx> backward;
+                    bool renamable = true;
+                    for(std::size_t i = 0; i < kernel.size() && renamable; ++i) {
+                        for(std::size_t t = 0; t < tags && renamable; ++t) {
+                            RegIdx a = kernel[i].second[t];
+                            RegIdx b = kernels[candidate][i].second[t];
+                            if(a == NO_REGISTER || b == NO_REGISTER) {
+                                renamable = (a == b);
+                                continue;
+                            }
+                            renamable = forward.emplace(a, b).first->second == b && backward.emplace(b, a).first->second == a;
+                        }
+                    }
+
+                    if(renamable) {
+                        std::vector<Command> commands;
+                        for(auto [a, b]: forward) {
+                            if(a >= first_fresh) {
+                                commands.emplace_back(b, NO_REGISTER);
+                            }
+                            else if(a != b) {
+                                commands.emplace_back(b, a);
+                            }
+                        }
+                        _registers = first_fresh;
+                        return {candidate, commands};
+                    }
+                }
+
+                std::vector<Command> commands;
+                for(auto reg: fresh) {
+                    if(reg != NO_REGISTER) {
+                        commands.emplace_back(reg, NO_REGISTER);
+                    }
+                }
+                StateIdx state = kernels.size();
+                kernels.push_back(std::move(kernel));
+                by_states[key].push_back(state);
+                queue.push(state);
+                return {state, commands};
+            };
+
+            _initial = intern(closure({{entry, std::vector<RegIdx>(tags, NO_REGISTER)}})).second;
+
+            while(!queue.empty()) {
+                StateIdx state = queue.front();
+                queue.pop();
+                Kernel current = kernels[state];
+
+                for(std::size_t c = 0; c < inputs.size(); ++c) {
+                    Kernel seeds;
+                    for(auto const& [from, regs]: current) {
+                        if(auto to = nfa.move(from, inputs[c])) {
+                            seeds.emplace_back(*to, regs);
+                        }
+                    }
+
+                    Kernel next = closure(seeds);
+                    Edge edge{DEAD_STATE, {}};
+                    if(!next.empty()) {
+                        std::tie(edge.to, edge.commands) = intern(std::move(next));
+                    }
+                    _edges[c].resize(kernels.size());
+                    _edges[c][state] = std::move(edge);
+                }
+            }
+
+            for(auto& edges: _edges) {
+                edges.resize(kernels.size());
+            }
+            for(auto const& kernel: kernels) {
+                auto final = std::ranges::find(kernel, exit, &Config::first);
+                _finals.push_back((final != kernel.end()) ? std::optional{final->second} : std::nullopt);
+            }
+        }
+
+        /**
+         * @brief Returns the number of states. The dead state is not counted.
+         */
+        StateIdx state_count() const {
+            return _finals.size();
+        }
+
+        /**
+         * @brief Returns the number of registers used to store the positions of the tags.
+         */
+        std::size_t register_count() const {
+            return _registers;
+        }
+
+        /**
+         * @brief Returns the number of groups (i.e. the highest group index plus one).
+         */
+        std::size_t group_count() const {
+            return _groups;
+        }
+
+        /**
+         * @brief Find the length of the longest prefix belonging to \f$ \mathcal{L} \f$.
+         * @see \ref DFA::munch()
+         */
+        template<input_range_of<T> R>
+        std::optional<std::size_t> munch(R&& sequence) const {
+            StateIdx state = 0;
+            std::size_t step = 0;
+            std::optional<std::size_t> res = _finals[state].has_value() ? std::optional<std::size_t>{0} : std::nullopt;
+
+            for(
+                auto beg = std::ranges::begin(sequence), end = std::ranges::end(sequence);
+                beg != end;
+                ++beg
+            ) {
+                state = edges(*beg)[state].to;
+                if(state == DEAD_STATE) {
+                    break;
+                }
+
+                ++step;
+                if(_finals[state].has_value()) {
+                    res = step;
+                }
+            }
+
+            return res;
+        }
+
+        /**
+         * @brief Find the longest prefix belonging to \f$ \mathcal{L} \f$, and the subsequences captured within it.
+         *
+         * The sequence is only read once (and not beyond the point where no longer prefix can match).
+         *
+         * @return Empty if no prefix belongs to the language, otherwise the length of the longest prefix and the submatches.
+         */
+        template<input_range_of<T> R>
+        std::optional<Submatches> munch_submatches(R&& sequence) const {
+            std::vector<std::size_t> registers(_registers, NO_POSITION);
+            std::vector<std::size_t> values;
+            std::vector<std::size_t> tags(2 * _groups, NO_POSITION);
+            std::optional<std::size_t> length;
+
+            auto execute = [&registers, &values](std::vector<Command> const& commands, std::size_t position) {
+                values.clear();
+                for(auto [dst, src]: commands) {
+                    values.push_back((src == NO_REGISTER) ? position : registers[src]);
+                }
+                for(std::size_t i = 0; i < commands.size(); ++i) {
+                    registers[commands[i].first] = values[i];
+                }
+            };
+
+            auto accept = [this, &registers, &tags, &length](StateIdx state, std::size_t position) {
+                if(_finals[state].has_value()) {
+                    length = position;
+                    std::ranges::transform(*_finals[state], tags.begin(), [&registers](RegIdx reg){
+                        return (reg == NO_REGISTER) ? NO_POSITION : registers[reg];
+                    });
+                }
+            };
+
+            StateIdx state = 0;
+            std::size_t position = 0;
+            execute(_initial, position);
+            accept(state, position);
+
+            for(
+                auto beg = std::ranges::begin(sequence), end = std::ranges::end(sequence);
+                beg != end;
+                ++beg
+            ) {
+                Edge const& edge = edges(*beg)[state];
+                if(edge.to == DEAD_STATE) {
+                    break;
+                }
+
+                ++position;
+                execute(edge.commands, position);
+                state = edge.to;
+                accept(state, position);
+            }
+
+            if(!length.has_value()) {
+                return std::nullopt;
+            }
+
+            Submatches result{*length, {}};
+            for(std::size_t group = 0; group < _groups; ++group) {
+                std::size_t start = tags[2 * group];
+                std::size_t end = tags[2 * group + 1];
+                if(start != NO_POSITION && end != NO_POSITION && start <= end) {
+                    result.groups.emplace_back(Match{start, end - start});
+                }
+                else {
+                    result.groups.emplace_back(std::nullopt);
+                }
+            }
+            return result;
+        }
+    };
+
+    /**
+     * @brief Converts a regex with captures into an equivalent tagged DFA.
+     *
+     * @tparam T Type of literals.
+     * @exception std::invalid_argument If a capture appears within a complement or a conjunction.
+     */
+    template<typename T>
+    TaggedDFA<T> make_tagged_dfa(Regex<T> const& regex) {
+        return TaggedDFA<T>(regex);
+    }
+}
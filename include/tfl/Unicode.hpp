@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Automata.hpp"
+#include "AutomataOps.hpp"
+#include "Regex.hpp"
+#include "RegexOps.hpp"
+
+/**
+ * @brief Contains the compilation of Unicode regexes into regexes and automata over their UTF-8 encoding.
+ * @file
+ */
+
+namespace tfl {
+
+    namespace matchers {
+
+        namespace {
+
+            // Sorted, disjoint and non-adjacent intervals of code points.
+            using CodePoints = std::vector<std::pair<char32_t, char32_t>>;
+
+            constexpr char32_t MAX_CODE_POINT = 0x10FFFF;
+            constexpr std::pair<char32_t, char32_t> SURROGATES{0xD800, 0xDFFF};
+
+            CodePoints united(CodePoints const& left, CodePoints const& right) {
+                CodePoints intervals;
+                std::ranges::merge(left, right, std::back_inserter(intervals));
+                CodePoints result;
+                for(auto const& [low, high]: intervals) {
+                    if(!result.empty() && low <= result.back().second + 1) {
+                        result.back().second = std::max(result.back().second, high);
+                    }
+                    else {
+                        result.emplace_back(low, high);
+                    }
+                }
+                return result;
+            }
+
+            CodePoints intersected(CodePoints const& left, CodePoints const& right) {
+                CodePoints result;
+                auto l = left.begin(), r = right.begin();
+                while(l != left.end() && r != right.end()) {
+                    char32_t low = std::max(l->first, r->first), high = std::min(l->second, r->second);
+                    if(low <= high) {
+                        result.emplace_back(low, high);
+                    }
+                    if(l->second < r->second) {
+                        ++l;
+                    }
+                    else {
+                        ++r;
+                    }
+                }
+                return result;
+            }
+
+            CodePoints subtracted(CodePoints const& left, CodePoints const& right) {
+                CodePoints complement;
+                char32_t low = 0;
+                for(auto const& [first, last]: right) {
+                    if(low < first) {
+                        complement.emplace_back(low, first - 1);
+                    }
+                    low = last + 1;
+                }
+                if(low <= MAX_CODE_POINT) {
+                    complement.emplace_back(low, MAX_CODE_POINT);
+                }
+                return intersected(left, complement);
+            }
+
+            std::vector<unsigned char> encode(char32_t c) {
+                if(c < 0x80) {
+                    return {static_cast<unsigned char>(c)};
+                }
+                else if(c < 0x800) {
+                    return {static_cast<unsigned char>(0xC0 | (c >> 6)), static_cast<unsigned char>(0x80 | (c & 0x3F))};
+                }
+                else if(c < 0x10000) {
+                    return {
+                        static_cast<unsigned char>(0xE0 | (c >> 12)),
+                        static_cast<unsigned char>(0x80 | ((c >> 6) & 0x3F)),
+                        static_cast<unsigned char>(0x80 | (c & 0x3F))
+                    };
+                }
+                return {
+                    static_cast<unsigned char>(0xF0 | (c >> 18)),
+                    static_cast<unsigned char>(0x80 | ((c >> 12) & 0x3F)),
+                    static_cast<unsigned char>(0x80 | ((c >> 6) & 0x3F)),
+                    static_cast<unsigned char>(0x80 | (c & 0x3F))
+                };
+            }
+
+            // Encodes code points of the same encoded length, which only differ by ranges of bytes.
+            Regex<char> encode(char32_t low, char32_t high) {
+                std::vector<unsigned char> lows = encode(low), highs = encode(high);
+                Regex<char> sequence = Regex<char>::epsilon();
+                for(std::size_t i = lows.size(); i-- > 0;) {
+                    std::vector<char> bytes;
+                    for(unsigned byte = lows[i]; byte <= highs[i]; ++byte) {
+                        bytes.push_back(static_cast<char>(byte));
+                    }
+                    sequence = Regexes<char>::any_of(bytes) - sequence;
+                }
+                return sequence;
+            }
+
+            // Encodes code points (except the surrogates, which have no encoding) as a regex accepting their UTF-8 encodings.
+            //
+            // As in RE2, the intervals are split until the encodings of the code points of each interval have
+            // the same length, and only differ by ranges of bytes: each interval is then a sequence of byte ranges.
+            Regex<char> encode(CodePoints const& code_points) {
+                CodePoints stack = subtracted(code_points, {SURROGATES});
+                std::vector<Regex<char>> sequences;
+
+                while(!stack.empty()) {
+                    auto [low, high] = stack.back();
+                    stack.pop_back();
+
+                    auto split = [&, low = low, high = high](char32_t last) {
+                        stack.emplace_back(last + 1, high);
+                        stack.emplace_back(low, last);
+                        return true;
+                    };
+
+                    bool splitted = false;
+                    // The last code points encoded with 1, 2 and 3 bytes.
+                    for(char32_t last: {0x7F, 0x7FF, 0xFFFF}) {
+                        if(!splitted && low <= last && last < high) {
+                            splitted = split(last);
+                        }
+                    }
+                    // The code points whose encodings only differ by their `i` last bytes.
+                    for(unsigned i = 1; !splitted && high > 0x7F && i < 4; ++i) {
+                        char32_t mask = (char32_t{1} << (6 * i)) - 1;
+                        if((low & ~mask) == (high & ~mask)) {
+                            break;
+                        }
+                        else if((low & mask) != 0) {
+                            splitted = split(low | mask);
+                        }
+                        else if((high & mask) != mask) {
+                            splitted = split((high & ~mask) - 1);
+                        }
+                    }
+
+                    if(!splitted) {
+                        sequences.push_back(encode(low, high));
+                    }
+                }
+
+                return Regexes<char>::any_of(sequences);
+            }
+
+            // A Unicode regex compiled to UTF-8. The sets of code points (and their complements) are kept
+            // as intervals until they are combined with other regexes, so that their encoding is split once.
+            struct Utf8 final {
+                enum class Kind { CODE_POINTS, COMPLEMENTED_CODE_POINTS, BYTES };
+
+                Kind kind;
+                CodePoints code_points = {};
+                Regex<char> bytes = Regex<char>::empty();
+            };
+
+            class Utf8Compiler final: public MemoBase<char32_t, Utf8> {
+                using Kind = Utf8::Kind;
+                using MemoBase<char32_t, Utf8>::memo;
+
+                // The UTF-8 encodings of the sequences of code points.
+                Regex<char> const _valid = *encode(CodePoints{{0, MAX_CODE_POINT}});
+
+                Regex<char> bytes(Regex<char32_t> const& regex) {
+                    Utf8 const& compiled = memo(regex);
+                    switch(compiled.kind) {
+                        case Kind::CODE_POINTS: return encode(compiled.code_points);
+                        case Kind::COMPLEMENTED_CODE_POINTS: return _valid & ~encode(compiled.code_points);
+                        default: return compiled.bytes;
+                    }
+                }
+
+                static Utf8 code_points(Kind kind, CodePoints code_points) {
+                    return {kind, std::move(code_points)};
+                }
+
+                static Utf8 bytes_of(Regex<char> bytes) {
+                    return {Kind::BYTES, {}, std::move(bytes)};
+                }
+
+            public:
+                Utf8Compiler(): MemoBase<char32_t, Utf8>(false) {}
+
+                Regex<char> compile(Regex<char32_t> const& regex) {
+                    return bytes(regex);
+                }
+
+                Utf8 empty() { return code_points(Kind::CODE_POINTS, {}); }
+                Utf8 epsilon() { return bytes_of(Regex<char>::epsilon()); }
+                Utf8 alphabet() { return code_points(Kind::CODE_POINTS, {{0, MAX_CODE_POINT}}); }
+                Utf8 literal(char32_t const& c) {
+                    if(c > MAX_CODE_POINT || (SURROGATES.first <= c && c <= SURROGATES.second)) {
+                        throw std::invalid_argument("Not a Unicode scalar value: " + std::to_string(static_cast<std::uint32_t>(c)));
+                    }
+                    return code_points(Kind::CODE_POINTS, {{c, c}});
+                }
+                Utf8 disjunction(Regex<char32_t> const& left, Regex<char32_t> const& right) {
+                    Utf8 const& l = memo(left);
+                    Utf8 const& r = memo(right);
+                    if(l.kind == Kind::CODE_POINTS && r.kind == Kind::CODE_POINTS) {
+                        return code_points(Kind::CODE_POINTS, united(l.code_points, r.code_points));
+                    }
+                    else if(l.kind == Kind::COMPLEMENTED_CODE_POINTS && r.kind == Kind::COMPLEMENTED_CODE_POINTS) {
+                        return code_points(Kind::COMPLEMENTED_CODE_POINTS, intersected(l.code_points, r.code_points));
+                    }
+                    else if(l.kind == Kind::COMPLEMENTED_CODE_POINTS && r.kind == Kind::CODE_POINTS) {
+                        return code_points(Kind::COMPLEMENTED_CODE_POINTS, subtracted(l.code_points, r.code_points));
+                    }
+                    else if(l.kind == Kind::CODE_POINTS && r.kind == Kind::COMPLEMENTED_CODE_POINTS) {
+                        return code_points(Kind::COMPLEMENTED_CODE_POINTS, subtracted(r.code_points, l.code_points));
+                    }
+                    return bytes_of(bytes(left) | bytes(right));
+                }
+                Utf8 sequence(Regex<char32_t> const& left, Regex<char32_t> const& right) { return bytes_of(bytes(left) - bytes(right)); }
+                Utf8 kleene_star(Regex<char32_t> const& regex) { return bytes_of(*bytes(regex)); }
+                Utf8 complement(Regex<char32_t> const& regex) {
+                    Utf8 const& compiled = memo(regex);
+                    switch(compiled.kind) {
+                        case Kind::CODE_POINTS: return code_points(Kind::COMPLEMENTED_CODE_POINTS, compiled.code_points);
+                        case Kind::COMPLEMENTED_CODE_POINTS: return code_points(Kind::CODE_POINTS, compiled.code_points);
+                        default: return bytes_of(_valid & ~compiled.bytes);
+                    }
+                }
+                Utf8 conjunction(Regex<char32_t> const& left, Regex<char32_t> const& right) {
+                    Utf8 const& l = memo(left);
+                    Utf8 const& r = memo(right);
+                    if(l.kind == Kind::CODE_POINTS && r.kind == Kind::CODE_POINTS) {
+                        return code_points(Kind::CODE_POINTS, intersected(l.code_points, r.code_points));
+                    }
+                    else if(l.kind == Kind::COMPLEMENTED_CODE_POINTS && r.kind == Kind::COMPLEMENTED_CODE_POINTS) {
+                        return code_points(Kind::COMPLEMENTED_CODE_POINTS, united(l.code_points, r.code_points));
+                    }
+                    else if(l.kind == Kind::CODE_POINTS && r.kind == Kind::COMPLEMENTED_CODE_POINTS) {
+                        return code_points(Kind::CODE_POINTS, subtracted(l.code_points, r.code_points));
+                    }
+                    else if(l.kind == Kind::COMPLEMENTED_CODE_POINTS && r.kind == Kind::CODE_POINTS) {
+                        return code_points(Kind::CODE_POINTS, subtracted(r.code_points, l.code_points));
+                    }
+                    return bytes_of(bytes(left) & bytes(right));
+                }
+                Utf8 capture(std::size_t group, Regex<char32_t> const& regex) {
+                    return bytes_of(Regex<char>::capture(group, bytes(regex)));
+                }
+                Utf8 repetition(Regex<char32_t> const& regex, std::size_t min, std::size_t max) {
+                    return bytes_of(Regex<char>::repeat(bytes(regex), min, max));
+                }
+            };
+        }
+    }
+
+    /**
+     * @brief Compiles a regex over code points into a regex over the bytes of their UTF-8 encoding.
+     *
+     * \f[ \mathcal{L} = \{ \textup{UTF-8}(w) \mid w \in \mathcal{L}(R) \} \f]
+     *
+     * The sets of code points (literals, \f$ \Sigma \f$ and their unions, intersections and complements) are
+     * compiled into sequences of byte ranges, by splitting their intervals as in RE2, rather than into a union
+     * of the encodings of each code point. \f$ \Sigma \f$ is any Unicode scalar value, and the complements
+     * only contain valid UTF-8 sequences.
+     *
+     * @exception std::invalid_argument If a literal is not a Unicode scalar value (i.e. is a surrogate or above U+10FFFF).
+     */
+    inline Regex<char> to_utf8(Regex<char32_t> const& regex) {
+        return matchers::Utf8Compiler().compile(regex);
+    }
+
+    /**
+     * @brief Converts a regex over code points into a DFA over the bytes of their UTF-8 encoding (see \ref to_utf8()).
+     *
+     * The DFA runs on the raw UTF-8 input, without decoding it; invalid UTF-8 sequences are never accepted.
+     * It is determinized from the partial-derivative automaton (see \ref make_nfa_by_partial_derivatives()), 
+     * in which the byte ranges following the same prefix lead to the same state.
+     * The DFAs can be used by the lexers (see \ref Lexer::make_dfa_lexer()).
+     *
+     * @exception std::invalid_argument If a literal is not a Unicode scalar value.
+     */
+    inline DFA<char> make_utf8_dfa(Regex<char32_t> const& regex) {
+        return make_partial_derivative_automaton(to_utf8(regex)).make_deterministic();
+    }
+}
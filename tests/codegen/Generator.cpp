@@ -0,0 +1,31 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+
+#include <tfl/AutomataOps.hpp>
+#include <tfl/Codegen.hpp>
+
+#include "Spec.hpp"
+
+template<typename T>
+bool generate(std::string const& path, std::string const& name) {
+    CodegenSpec<T> spec;
+    std::ofstream output(path);
+    output << tfl::cpp_source<T>(name, {
+        {"identifier",  tfl::make_dfa(spec.identifier)},
+        {"number",      tfl::make_dfa(spec.number)},
+        {"utf8",        tfl::make_dfa(spec.utf8)},
+        {"quoted",      tfl::make_dfa(spec.quoted)},
+        {"high",        tfl::make_dfa(spec.high)},
+    });
+    return static_cast<bool>(output);
+}
+
+int main(int argc, char** argv) {
+    if(argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <char scanner> <unsigned char scanner>" << std::endl;
+        return 1;
+    }
+
+    return generate<char>(argv[1], "scanner") && generate<unsigned char>(argv[2], "byte_scanner") ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <tfl/Regex.hpp>
+
+/**
+ * The tokens of the scanners generated for the tests, shared by the generator and the tests.
+ * They use values above 0x7F (negative if `T` is signed), unknown values, and complements.
+ */
+template<typename T>
+class CodegenSpec: tfl::Regexes<T> {
+    using R = tfl::Regexes<T>;
+    using Regex = tfl::Regex<T>;
+
+    static T byte(unsigned value) {
+        return static_cast<T>(value);
+    }
+
+    Regex const digit       = R::range(byte('0'), byte('9'));
+    Regex const alpha       = R::range(byte('a'), byte('z')) | R::literal(byte('_'));
+    Regex const quote       = R::literal(byte('"'));
+
+public:
+    Regex const identifier  = alpha - *(alpha | digit);
+    Regex const number      = +digit - R::opt(R::literal(byte('.')) - +digit);
+    // Two-byte UTF-8 sequences.
+    Regex const utf8        = +(R::range(byte(0xC2), byte(0xDF)) - R::range(byte(0x80), byte(0xBF)));
+    Regex const quoted      = quote - *(R::alphabet() / quote) - quote;
+    Regex const high        = R::literal(byte(0xFF)) - R::opt(R::literal(byte(0xFE)) | R::literal(byte('a')));
+};
@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "tfl/AutomataOps.hpp"
+
+#include <string>
+#include <vector>
+
+#include "Spec.hpp"
+
+// Generated from codegen/Spec.hpp by the "TestsScannerGenerator" target.
+#include "CodegenScanner.hpp"
+#include "CodegenByteScanner.hpp"
+
+namespace {
+    template<typename T>
+    std::vector<std::vector<T>> all_words(std::vector<unsigned> const& alphabet, std::size_t max_length) {
+        std::vector<std::vector<T>> words{{}};
+        for(std::size_t i = 0; i < words.size() && words[i].size() < max_length; ++i) {
+            for(unsigned value: alphabet) {
+                words.push_back(words[i]);
+                words.back().push_back(static_cast<T>(value));
+            }
+        }
+        return words;
+    }
+
+    template<typename T, typename A>
+    void check_scanner(A const& generated, tfl::Regex<T> const& regex) {
+        auto dfa = tfl::make_dfa(regex);
+        for(auto const& word: all_words<T>({'a', '1', '.', '"', 0xC3, 0xA9, 0xFE, 0xFF}, 4)) {
+            INFO( std::string(word.begin(), word.end()) );
+            CHECK( generated.munch(word) == dfa.munch(word) );
+        }
+    }
+}
+
+TEST_CASE("Generated scanners munch like DFAs", "[automata][codegen]") {
+    SECTION("Signed literals") {
+        CodegenSpec<char> spec;
+        check_scanner(scanner::identifier, spec.identifier);
+        check_scanner(scanner::number, spec.number);
+        check_scanner(scanner::utf8, spec.utf8);
+        check_scanner(scanner::quoted, spec.quoted);
+        check_scanner(scanner::high, spec.high);
+    }
+
+    SECTION("Unsigned literals") {
+        CodegenSpec<unsigned char> spec;
+        check_scanner(byte_scanner::identifier, spec.identifier);
+        check_scanner(byte_scanner::number, spec.number);
+        check_scanner(byte_scanner::utf8, spec.utf8);
+        check_scanner(byte_scanner::quoted, spec.quoted);
+        check_scanner(byte_scanner::high, spec.high);
+    }
+}
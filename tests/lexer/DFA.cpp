@@ -1,6 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "tfl/Automata.hpp"
+#include "tfl/AutomataOps.hpp"
+
+#include <list>
+#include <sstream>
+#include <string>
 
 using DFA = tfl::DFA<char>;
 using NFA = tfl::NFA<char>;
@@ -333,4 +338,207 @@ TEST_CASE("DFAs can be converted into NFAs", "[automata][nd-conversion]") {
         CHECK( !nfa.accepts({'c', 'a', 'b', 'a', 'c'}) );
         CHECK( nfa.accepts({'c', 'a', 'b', 'a', 'b', 'c'}) );
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Self-looping states are skipped on contiguous inputs", "[automata][DFA]") {
+    using Regex = tfl::Regex<char>;
+    using Regexes = tfl::Regexes<char>;
+
+    auto quote = Regex::literal('"');
+    auto backslash = Regex::literal('\\');
+    auto string = quote - *((Regex::alphabet() / (backslash | quote)) | (backslash - Regex::alphabet())) - quote;
+    auto comment = Regex::literal('#') - *(Regex::alphabet() / Regex::literal('\n'));
+    auto spaces = *Regexes::any_of({' ', '\t'});
+
+    std::vector<std::string> inputs;
+    for(std::size_t length: {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000}) {
+        std::string body(length, 'x');
+        inputs.push_back('"' + body + '"');
+        inputs.push_back('"' + body + "\\\"" + body + "\" tail");
+        inputs.push_back('"' + body);
+        inputs.push_back('#' + body + "\n" + body);
+        inputs.push_back('#' + body);
+        inputs.push_back(std::string(length, ' ') + "\t" + std::string(length, ' ') + "x");
+    }
+
+    for(auto const& regex: {string, comment, spaces}) {
+        DFA dfa = tfl::make_dfa(regex);
+        for(auto const& input: inputs) {
+            INFO( input );
+            std::list<char> list(input.begin(), input.end());
+            CHECK( dfa.munch(input) == dfa.munch(list) );
+            CHECK( dfa.accepts(input) == dfa.accepts(list) );
+            CHECK( dfa.accepts(input) == tfl::is_nullable(tfl::derive(input, regex)) );
+        }
+    }
+}
+
+TEST_CASE("DFAs find leftmost-longest matches", "[DFA]") {
+    using Regex = tfl::Regex<char>;
+    using Regexes = tfl::Regexes<char>;
+
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+    Regex c = Regex::literal('c');
+
+    std::vector<Regex> regexes{
+        Regex::empty(),
+        Regex::epsilon(),
+        a,
+        (a - b) | (b - c - a) | (c - *a),
+        *(a - b) - c,
+        (a | b) - *(b | c) - a,
+        (Regexes::opt(a) - b - c) & (Regex::any() - c),
+        (a - ~(Regex::any() - c - Regex::any())) / (Regex::any() - b),
+        (a - b - c) | b,
+    };
+
+    std::vector<std::string> inputs{""};
+    for(std::size_t i = 0; i < inputs.size() && inputs[i].size() < 6; ++i) {
+        for(char x: {'a', 'b', 'c', 'x'}) {
+            inputs.push_back(inputs[i] + x);
+        }
+    }
+
+    for(auto const& regex: regexes) {
+        INFO( tfl::to_string(regex) );
+        DFA dfa = tfl::make_dfa(regex);
+
+        for(auto const& input: inputs) {
+            INFO( input );
+
+            // Munching at every position.
+            std::vector<tfl::Match> expected;
+            for(std::size_t position = 0; position <= input.size();) {
+                auto length = dfa.munch(input.substr(position));
+                if(length.has_value()) {
+                    expected.push_back({position, *length});
+                }
+                position += length.has_value() ? std::max<std::size_t>(*length, 1) : 1;
+            }
+
+            CHECK( dfa.find_all(input) == expected );
+            CHECK( dfa.find_all(std::list<char>(input.begin(), input.end())) == expected );
+            REQUIRE( dfa.find(input).has_value() == !expected.empty() );
+            if(!expected.empty()) {
+                CHECK( dfa.find(input) == expected.front() );
+            }
+        }
+    }
+
+    SECTION("Input ranges") {
+        DFA dfa = tfl::make_dfa((a - b) | (b - c - a) | (c - *a));
+        std::istringstream stream("xbcaabcaaa");
+        auto view = std::views::istream<char>(stream);
+        CHECK( dfa.find_all(view) == std::vector<tfl::Match>{{1, 3}, {4, 2}, {6, 4}} );
+    }
+}
+
+TEST_CASE("DFAs can be reversed", "[DFA]") {
+    using Regex = tfl::Regex<char>;
+    using Regexes = tfl::Regexes<char>;
+
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+    Regex c = Regex::literal('c');
+
+    std::vector<Regex> regexes{
+        Regex::empty(),
+        Regex::epsilon(),
+        Regex::any(),
+        a - b - *c,
+        (a | (b - c)) - *(a - b),
+        ~(Regex::any() - a - b - Regex::any()),
+        (Regexes::opt(a) - b - c) & (Regex::any() - c),
+    };
+
+    std::vector<std::string> inputs{""};
+    for(std::size_t i = 0; i < inputs.size() && inputs[i].size() < 5; ++i) {
+        for(char x: {'a', 'b', 'c', 'x'}) {
+            inputs.push_back(inputs[i] + x);
+        }
+    }
+
+    for(auto const& regex: regexes) {
+        INFO( tfl::to_string(regex) );
+        DFA dfa = tfl::make_dfa(regex);
+        DFA reversed = tfl::make_reverse_dfa(regex);
+
+        for(auto const& input: inputs) {
+            INFO( input );
+            std::string backward(input.rbegin(), input.rend());
+            CHECK( reversed.accepts(backward) == dfa.accepts(input) );
+
+            std::optional<std::size_t> expected;
+            for(std::size_t l = 0; l <= input.size(); ++l) {
+                if(dfa.accepts(input.substr(input.size() - l))) {
+                    expected = l;
+                }
+            }
+            CHECK( reversed.munch_backward(input) == expected );
+            CHECK( reversed.munch_backward(std::list<char>(input.begin(), input.end())) == expected );
+        }
+    }
+
+    SECTION("Builders") {
+        DFA reversed = DFA::Builder({'a', 'b'}, 3)
+            .set_transition(0, 'a', 1)
+            .set_transition(1, 'b', 2)
+            .set_acceptance(2, true)
+            .complete(DEAD_STATE)
+            .reverse();
+
+        CHECK( reversed.accepts({'b', 'a'}) );
+        CHECK( !reversed.accepts({'a', 'b'}) );
+        CHECK( !reversed.accepts({}) );
+    }
+}
+
+TEST_CASE("DFAs over ordered alphabets store their transitions per interval", "[automata][DFA]") {
+    using WideDFA = tfl::DFA<char32_t>;
+
+    // [a-z]+ or a CJK ideograph, with 'q' leading elsewhere.
+    WideDFA::Builder builder(3);
+    for(char32_t c = 'a'; c <= 'z'; ++c) {
+        builder.add_input(c);
+        builder.set_transition(0, c, 1);
+        builder.set_transition(1, c, 1);
+        builder.set_transition(2, c, DEAD_STATE);
+    }
+    for(char32_t c = 0x4E00; c <= 0x9FFF; ++c) {
+        builder.add_input(c);
+        builder.set_transition(0, c, 2);
+        builder.set_transition(1, c, DEAD_STATE);
+        builder.set_transition(2, c, DEAD_STATE);
+    }
+    builder.set_transition(0, 'q', DEAD_STATE)
+        .set_unknown_transition(0, DEAD_STATE)
+        .set_unknown_transition(1, DEAD_STATE)
+        .set_all_transitions(2, DEAD_STATE)
+        .set_acceptance({1, 2}, true);
+    WideDFA dfa = builder;
+
+    CHECK( dfa.class_count() == 4 );
+    CHECK( std::ranges::distance(dfa.alphabet()) == 26 + 0x5200 );
+
+    CHECK( dfa.accepts(std::u32string(U"abz")) );
+    CHECK( dfa.accepts(std::u32string(U"aq")) );
+    CHECK( !dfa.accepts(std::u32string(U"qa")) );
+    CHECK( dfa.accepts(std::u32string(U"一")) );
+    CHECK( dfa.accepts(std::u32string(U"鿿")) );
+    CHECK( !dfa.accepts(std::u32string(U"䷿")) );
+    CHECK( !dfa.accepts(std::u32string(U"ꀀ")) );
+    CHECK( !dfa.accepts(std::u32string(U"一a")) );
+    CHECK( dfa.transition(0, 0x5000) == 2 );
+    CHECK( dfa.step(0, 0xA000) == DEAD_STATE );
+    CHECK_THROWS_AS( dfa.transition(0, 0xA000), std::invalid_argument );
+
+    // The symbols of a range are a single position of the Glushkov automaton, hence a single class.
+    WideDFA ideographs = tfl::make_dfa(+tfl::Regexes<char32_t>::range(0x4E00, 0x9FFF));
+    CHECK( ideographs.class_count() == 1 );
+    CHECK( ideographs.state_count() == 3 );
+    CHECK( ideographs.accepts(std::u32string(U"世界")) );
+
+    // Byte alphabets keep one class per symbol.
+    CHECK( tfl::make_dfa(tfl::Regexes<char>::range('a', 'z')).class_count() == 26 );
+}
@@ -3,6 +3,8 @@
 
 #include "tfl/Lexer.hpp"
 
+#include <random>
+#include <sstream>
 #include <string>
 #include <variant>
 
@@ -80,7 +82,14 @@ struct DFALexer {
     }
 };
 
-#define LEXERS DerivationLexer, DFALexer
+struct TaggedDFALexer {
+    template<typename T, typename R>
+    static tfl::Lexer<T, tfl::Positioned<R>> make(std::initializer_list<tfl::Rule<T, tfl::Regex<T>, R>> rules, tfl::Regex<T> newline = tfl::Regex<T>::empty()) {
+        return tfl::Lexer<T, R>::make_tagged_dfa_lexer(rules, newline);
+    }
+};
+
+#define LEXERS DerivationLexer, DFALexer, TaggedDFALexer
 
 TEMPLATE_TEST_CASE("Simple usecase", "[template]", LEXERS) {
     using R = std::variant<std::string, int, SpecialSymbol>;
@@ -192,4 +201,336 @@ TEMPLATE_TEST_CASE("Throws when no rule is applicable", "[template]", LEXERS) {
     });
 
     REQUIRE_THROWS_AS( lexer("NotDigits"), tfl::LexingException );
-}
\ No newline at end of file
+}
+
+TEST_CASE("Captured subsequences are passed to rule maps", "[lexer]") {
+    using Regex = tfl::Regex<char>;
+    using Regexes = tfl::Regexes<char>;
+    using Rule = tfl::Rule<char, Regex, std::string>;
+
+    auto quote = Regexes::literal('"');
+    auto digit = Regexes::range('0', '9');
+    auto str = [](auto const& w){ return std::string(w.begin(), w.end()); };
+
+    auto lexer = tfl::Lexer<char, std::string>::make_tagged_dfa_lexer({
+        {quote - Regex::capture(0, *(Regex::alphabet() & ~quote)) - quote, [&str](auto, Rule::Captures const& captures){ return "string " + str(*captures[0]); }},
+        {Regex::capture(0, +digit) - Regexes::opt(Regexes::literal('.') - Regex::capture(1, +digit)), [&str](auto, Rule::Captures const& captures){
+            return "number " + str(*captures[0]) + (captures[1].has_value() ? " " + str(*captures[1]) : "");
+        }},
+        {Regexes::literal(' '), [](auto){ return std::string("sep"); }},
+    });
+
+    auto result = lexer(std::string("\"ab c\" 12.5 7"));
+    std::vector<std::string> values;
+    std::ranges::transform(result, std::back_inserter(values), [](auto const& p){ return p.value(); });
+    CHECK( values == std::vector<std::string>{"string ab c", "sep", "number 12 5", "sep", "number 7"} );
+}
+
+TEMPLATE_TEST_CASE("Tokens spanning several lines have start and end positions", "[template]", LEXERS) {
+    using Regexes = tfl::Regexes<char>;
+
+    auto slash = Regexes::literal('/');
+    auto star = Regexes::literal('*');
+    auto nl = Regexes::literal('\n');
+    auto lexer = TestType::template make<char, int>({
+        {slash - star - *(tfl::Regex<char>::alphabet() & ~star) - star - slash, [](auto){ return 0; }},
+        {+Regexes::range('a', 'z'), [](auto){ return 1; }},
+        {Regexes::literal(' ') | nl, [](auto){ return 2; }},
+    }, nl);
+
+    auto result = lexer(std::string("ab /* x\n\ny */ cd\n"));
+    REQUIRE( result.size() == 6 );
+
+    CHECK( result[2].value() == 0 );
+    CHECK( std::pair(result[2].line(), result[2].column()) == std::pair<size_t, size_t>(1, 4) );
+    CHECK( std::pair(result[2].end_line(), result[2].end_column()) == std::pair<size_t, size_t>(3, 5) );
+    CHECK( std::pair(result[4].line(), result[4].column()) == std::pair<size_t, size_t>(3, 6) );
+    CHECK( std::pair(result[5].end_line(), result[5].end_column()) == std::pair<size_t, size_t>(4, 1) );
+    CHECK( result[2].line_index()->position(8) == std::pair<size_t, size_t>(2, 1) );
+}
+
+TEMPLATE_TEST_CASE("Contiguous and streamed inputs have the same line index", "[template]", LEXERS) {
+    using Regexes = tfl::Regexes<char>;
+
+    auto cr = Regexes::literal('\r');
+    auto nl = Regexes::literal('\n');
+    auto word = +Regexes::range('a', 'z');
+    auto space = Regexes::literal(' ') | cr | nl;
+    std::string input("ab\ncd \r\nef\r\r\ngh\n");
+
+    // Single-byte newlines are found by a vectorized search, longer ones by the automaton.
+    for(auto const& newline: {nl, (cr - nl) | nl | cr, Regexes::opt(cr) - nl}) {
+        INFO( tfl::to_string(newline) );
+        auto lexer = TestType::template make<char, int>({
+            {word, [](auto){ return 0; }},
+            {space, [](auto){ return 1; }},
+        }, newline);
+
+        auto contiguous = lexer(input);
+        std::istringstream stream(input);
+        auto streamed = lexer(std::views::istream<char>(stream >> std::noskipws));
+
+        REQUIRE( contiguous.size() == streamed.size() );
+        for(std::size_t i = 0; i < contiguous.size(); ++i) {
+            INFO( std::to_string(i) + "th token" );
+            CHECK( contiguous[i] == streamed[i] );
+            CHECK( contiguous[i].end_line() == streamed[i].end_line() );
+            CHECK( contiguous[i].end_column() == streamed[i].end_column() );
+        }
+        CHECK( contiguous.back().end_column() == 1 );
+    }
+}
+
+TEST_CASE("Line indexes find every newline byte", "[lexer]") {
+    tfl::ByteSet newlines;
+    newlines.insert('\n');
+
+    std::string input;
+    for(std::size_t i = 0; i < 100; ++i) {
+        input += std::string(i, 'x') + '\n';
+    }
+
+    auto index = tfl::LineIndex::of(std::span<char const>(input), newlines);
+    REQUIRE( index.line_count() == 101 );
+    std::size_t offset = 0;
+    for(std::size_t line = 1; line <= 100; ++line) {
+        CHECK( index.line_start(line) == offset );
+        CHECK( index.position(offset + line - 1) == std::pair<std::size_t, std::size_t>(line, line) );
+        offset += line;
+    }
+}
+
+TEMPLATE_TEST_CASE("Recovering lexers turn unlexable values into error tokens", "[template]", LEXERS) {
+    using Regexes = tfl::Regexes<char>;
+    using Token = tfl::Positioned<std::string>;
+
+    auto str = [](auto const& w){ return std::string(w.begin(), w.end()); };
+    auto lexer = TestType::template make<char, std::string>({
+        {+Regexes::range('a', 'z'), str},
+        {Regexes::literal('1') - Regexes::literal('2') - Regexes::literal('3'), str},
+        {Regexes::literal(' ') | Regexes::literal('\n'), str},
+    }, Regexes::literal('\n'));
+    auto recovering = lexer.recovering([&str](auto const& w){ return "error " + str(w); });
+
+    std::string input("ab 12#12\n3 #?1123");
+    REQUIRE_THROWS_AS( lexer(input), tfl::LexingException );
+
+    // The error tokens stop where a rule applies, even if the match started there is not the longest one.
+    auto result = recovering(input);
+    std::vector<Token> expected{
+        Token(1, 1, "ab"), Token(1, 3, " "), Token(1, 4, "error 12#12"), Token(1, 9, "\n"),
+        Token(2, 1, "error 3"), Token(2, 2, " "), Token(2, 3, "error #?1"), Token(2, 6, "123"),
+    };
+    CHECK( result == expected );
+
+    std::istringstream stream(input);
+    CHECK( recovering(std::views::istream<char>(stream >> std::noskipws)) == expected );
+
+    CHECK( recovering(std::string("#")) == std::vector<Token>{Token(1, 1, "error #")} );
+    CHECK_THROWS_AS( lexer.map([](auto const& token){ return token.value(); }).recovering(str), tfl::LexingException );
+}
+
+TEST_CASE("Lexers built from DFAs recover with the rules' automata", "[lexer]") {
+    using Regexes = tfl::Regexes<char>;
+
+    auto digits = tfl::make_dfa(+Regexes::range('0', '9'));
+    auto word = tfl::make_dfa(Regexes::literal('a') - Regexes::literal('b'));
+    auto lexer = tfl::Lexer<char, int>::make_dfa_lexer({
+        tfl::Rule<char, tfl::DFA<char>, int>(digits, [](auto){ return 0; }),
+        tfl::Rule<char, tfl::DFA<char>, int>(word, [](auto){ return 1; }),
+    }).recovering([](auto const& w){ return -static_cast<int>(std::ranges::distance(w)); });
+
+    std::vector<int> values;
+    std::ranges::transform(lexer(std::string("aab12a-aab")), std::back_inserter(values), [](auto const& p){ return p.value(); });
+    CHECK( values == std::vector<int>{-1, 1, 0, -3, 1} );
+}
+
+TEMPLATE_TEST_CASE("Relexing after edits is the same as lexing from scratch", "[template]", LEXERS) {
+    using Regexes = tfl::Regexes<char>;
+    using Token = tfl::Positioned<std::string>;
+
+    auto a = Regexes::literal('a');
+    auto b = Regexes::literal('b');
+    auto c = Regexes::literal('c');
+    auto d = Regexes::literal('d');
+    auto str = [](auto const& w){ return std::string(w.begin(), w.end()); };
+
+    // The first rule reads ahead as far as the 'bc' repetitions go.
+    auto lexer = TestType::template make<char, std::string>({
+        {a - *(b - c) - d, str},
+        {Regexes::any_of({a, b, c, d}), str},
+        {+Regexes::literal(' '), str},
+        {Regexes::literal('\n'), str},
+    }, Regexes::literal('\n'));
+
+    auto check_same = [](std::vector<Token> const& relexed, std::vector<Token> const& expected) {
+        REQUIRE( relexed.size() == expected.size() );
+        for(std::size_t i = 0; i < expected.size(); ++i) {
+            INFO( std::to_string(i) + "th token" );
+            CHECK( relexed[i] == expected[i] );
+            CHECK( relexed[i].offset() == expected[i].offset() );
+            CHECK( relexed[i].length() == expected[i].length() );
+            CHECK( relexed[i].end_line() == expected[i].end_line() );
+            CHECK( relexed[i].end_column() == expected[i].end_column() );
+        }
+    };
+
+    SECTION("Edits far from the end keep the following tokens") {
+        std::string input("ab cd\nabcbcd d");
+        auto tokens = lexer(input);
+
+        input.replace(7, 1, "bcb");
+        auto relexed = lexer.relex(tokens, tfl::Edit{7, 1, 3}, input);
+        check_same(tokens, lexer(input));
+        CHECK( relexed.position == 6 );
+        CHECK( relexed.position + relexed.inserted < tokens.size() );
+    }
+
+    SECTION("Edits invalidating earlier lookaheads") {
+        std::string input("abcbcbc  a");
+        auto tokens = lexer(input);
+
+        input.replace(7, 0, "d");
+        lexer.relex(tokens, tfl::Edit{7, 0, 1}, input);
+        check_same(tokens, lexer(input));
+        CHECK( tokens.front().value() == "abcbcbcd" );
+    }
+
+    SECTION("Copies of the tokens keep their positions") {
+        std::string input("ab cd\nef gh");
+        auto simple = TestType::template make<char, std::string>({
+            {+Regexes::range('a', 'z'), str},
+            {Regexes::any_of({Regexes::literal(' '), Regexes::literal('\n')}), str},
+        }, Regexes::literal('\n'));
+        auto tokens = simple(input);
+        auto copy = tokens;
+
+        input.replace(0, 0, "\n\n\n");
+        simple.relex(tokens, tfl::Edit{0, 0, 3}, input);
+        check_same(tokens, simple(input));
+        CHECK( copy.back().line() == 2 );
+        CHECK( copy.back().column() == 4 );
+        CHECK( tokens.back().line() == 5 );
+        CHECK( tokens.back().column() == 4 );
+
+        // The edits not applied yet to the kept tokens are not applied to the copies either.
+        input.replace(2, 1, "");
+        simple.relex(tokens, tfl::Edit{2, 1, 0}, input);
+        auto pending = tokens;
+        input.replace(0, 1, "");
+        simple.relex(tokens, tfl::Edit{0, 1, 0}, input);
+        check_same(tokens, simple(input));
+        CHECK( pending.back().line() == 4 );
+        CHECK( pending.back().offset() == 11 );
+        CHECK( tokens.back().line() == 3 );
+        CHECK( tokens.back().offset() == 10 );
+    }
+
+    SECTION("Random edits") {
+        std::mt19937 generator(7);
+        std::uniform_int_distribution<int> letter(0, 5);
+        auto random_text = [&](std::size_t length) {
+            std::string text;
+            for(std::size_t i = 0; i < length; ++i) {
+                text.push_back("abcd \n"[letter(generator)]);
+            }
+            return text;
+        };
+
+        std::string input = random_text(200);
+        auto tokens = lexer(input);
+        for(int i = 0; i < 200; ++i) {
+            std::size_t position = std::uniform_int_distribution<std::size_t>(0, input.size())(generator);
+            std::size_t removed = std::uniform_int_distribution<std::size_t>(0, std::min<std::size_t>(3, input.size() - position))(generator);
+            std::string inserted = random_text(std::uniform_int_distribution<std::size_t>(0, 3)(generator));
+
+            input.replace(position, removed, inserted);
+            INFO( input );
+            lexer.relex(tokens, tfl::Edit{position, removed, inserted.size()}, input);
+            check_same(tokens, lexer(input));
+        }
+    }
+
+    SECTION("Random edits with newlines of several values") {
+        auto crlf = TestType::template make<char, std::string>({
+            {+Regexes::any_of({a, b}), str},
+            {Regexes::any_of({Regexes::literal('\r'), Regexes::literal('\n')}), str},
+        }, Regexes::literal('\r') - Regexes::literal('\n') | Regexes::literal('\r') | Regexes::literal('\n'));
+
+        std::mt19937 generator(11);
+        std::uniform_int_distribution<int> letter(0, 3);
+        auto random_text = [&](std::size_t length) {
+            std::string text;
+            for(std::size_t i = 0; i < length; ++i) {
+                text.push_back("ab\r\n"[letter(generator)]);
+            }
+            return text;
+        };
+
+        std::string input = random_text(200);
+        auto tokens = crlf(input);
+        for(int i = 0; i < 200; ++i) {
+            std::size_t position = std::uniform_int_distribution<std::size_t>(0, input.size())(generator);
+            std::size_t removed = std::uniform_int_distribution<std::size_t>(0, std::min<std::size_t>(3, input.size() - position))(generator);
+            std::string inserted = random_text(std::uniform_int_distribution<std::size_t>(0, 3)(generator));
+
+            input.replace(position, removed, inserted);
+            INFO( input );
+            crlf.relex(tokens, tfl::Edit{position, removed, inserted.size()}, input);
+            check_same(tokens, crlf(input));
+        }
+    }
+}
+
+TEST_CASE("Mapped lexers cannot relex", "[lexer]") {
+    using Regexes = tfl::Regexes<char>;
+    auto lexer = tfl::Lexer<char, int>::make_dfa_lexer({
+        {+Regexes::range('0', '9'), [](auto w){ return static_cast<int>(std::ranges::distance(w)); }}
+    }).map([](auto p){ return p.value(); });
+
+    std::string input("12");
+    auto tokens = lexer(input);
+    CHECK_THROWS_AS( lexer.relex(tokens, tfl::Edit{0, 0, 0}, input), tfl::LexingException );
+}
+
+TEST_CASE("Lexers built from DFAs drop the shadowed rules", "[lexer]") {
+    using Regex = tfl::Regex<char>;
+    using Regexes = tfl::Regexes<char>;
+
+    Regex letter = Regexes::range('a', 'z');
+    Regex digit = Regexes::range('0', '9');
+    auto rules = {
+        tfl::Rule<char, Regex, int>(+letter, [](auto){ return 0; }),
+        tfl::Rule<char, Regex, int>(+digit, [](auto){ return 1; }),
+        // Matched by the identifiers, which win ties.
+        tfl::Rule<char, Regex, int>(Regexes::word(std::string("if")), [](auto){ return 2; }),
+        // Only its empty match is shadowed, and the lexer never produces empty tokens anyway.
+        tfl::Rule<char, Regex, int>(*digit, [](auto){ return 3; }),
+        tfl::Rule<char, Regex, int>(letter - *(letter | digit), [](auto){ return 4; }),
+        tfl::Rule<char, Regex, int>(Regex::literal(' '), [](auto){ return 5; }),
+    };
+
+    auto values = [](auto const& lexer, std::string const& input) {
+        std::vector<int> values;
+        std::ranges::transform(lexer(input), std::back_inserter(values), [](auto const& p){ return p.value(); });
+        return values;
+    };
+
+    auto dfa_lexer = tfl::Lexer<char, int>::make_dfa_lexer(std::views::all(rules));
+    auto derivation_lexer = tfl::Lexer<char, int>::make_derivation_lexer(std::views::all(rules));
+    CHECK( dfa_lexer.pruned_rules() == std::vector<std::size_t>{2, 3} );
+    CHECK( dfa_lexer.map([](auto const& p){ return p.value(); }).pruned_rules() == std::vector<std::size_t>{2, 3} );
+    CHECK( derivation_lexer.pruned_rules().empty() );
+
+    std::string input("if x1 42 abc");
+    CHECK( values(dfa_lexer, input) == values(derivation_lexer, input) );
+    CHECK( values(dfa_lexer, input) == std::vector<int>{0, 5, 4, 5, 1, 5, 0} );
+
+    auto dfas = tfl::Lexer<char, int>::make_dfa_lexer({
+        tfl::Rule<char, tfl::DFA<char>, int>(tfl::make_dfa(+digit), [](auto){ return 0; }),
+        tfl::Rule<char, tfl::DFA<char>, int>(tfl::make_dfa(Regex::literal('0')), [](auto){ return 1; }),
+        tfl::Rule<char, tfl::DFA<char>, int>(tfl::make_dfa(Regex::literal('a')), [](auto){ return 2; }),
+    });
+    CHECK( dfas.pruned_rules() == std::vector<std::size_t>{1} );
+    CHECK( values(dfas, "0a7") == std::vector<int>{0, 2, 0} );
+}
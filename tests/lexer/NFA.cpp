@@ -1,6 +1,9 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "tfl/Automata.hpp"
+#include "tfl/AutomataOps.hpp"
+
+#include <vector>
 
 using DFA = tfl::DFA<char>;
 using NFA = tfl::NFA<char>;
@@ -235,4 +238,21 @@ TEST_CASE("NFAs can be converted into DFAs", "[automata][nd-conversion]") {
         CHECK( !dfa.accepts({'c', 'a', 'b', 'a', 'c'}) );
         CHECK( dfa.accepts({'c', 'a', 'b', 'a', 'b', 'c'}) );
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("NFAs are determinized per class of symbols", "[automata][nd-conversion]") {
+    using Regex = tfl::Regex<int>;
+    using Regexes = tfl::Regexes<int>;
+
+    Regex regex = +Regexes::range(100, 299) - Regex::literal(-100) - Regexes::range(-20, 20);
+    tfl::NFA<int> nfa = tfl::make_nfa_by_partial_derivatives(regex);
+    tfl::DFA<int> dfa = tfl::make_dfa(regex);
+
+    CHECK( nfa.class_count() == 3 );
+    CHECK( dfa.class_count() == 3 );
+    for(std::vector<int> word: std::vector<std::vector<int>>{{100, -100, 0}, {299, 200, -100, -20}, {100, -100}, {99, -100, 0}, {100, -100, 21}}) {
+        CHECK( nfa.accepts(word) == dfa.accepts(word) );
+    }
+    CHECK( dfa.accepts({299, 200, -100, -20}) );
+    CHECK( !dfa.accepts({100, -100, 21}) );
+}
@@ -4,6 +4,8 @@
 #include "tfl/Regex.hpp"
 #include "tfl/AutomataOps.hpp"
 
+#include <limits>
+
 using Regex = tfl::Regex<char>;
 using Regexes = tfl::Regexes<char>;
 
@@ -34,7 +36,16 @@ struct RegexNFA {
     }
 };
 
-#define ACCEPTERS RegexDerivation, RegexDFA, RegexNFA
+struct RegexPartialDerivatives {
+    static bool accepts(Regex const& r, std::initializer_list<char> ls) {
+        return tfl::make_nfa_by_partial_derivatives(r).accepts(ls);
+    }
+    static bool accepts_v(Regex const& r, std::vector<char> ls) {
+        return tfl::make_nfa_by_partial_derivatives(r).accepts(ls);
+    }
+};
+
+#define ACCEPTERS RegexDerivation, RegexDFA, RegexNFA, RegexPartialDerivatives
 
 static auto to_string = tfl::to_string<char>;
 
@@ -493,6 +504,35 @@ TEMPLATE_TEST_CASE("Additional regex combinators accept/reject as expected", "[t
         CHECK( !accepts(r, {'8'}) );
         CHECK( !accepts(r, {'9'}) );
     }
+
+    SECTION("Repetition (repeat)") {
+        auto r = Regexes::repeat(Regex::literal('a') | (Regex::literal('b') - Regex::literal('c')), 2, 3);
+
+        CHECK( !accepts(r, {}) );
+        CHECK( !accepts(r, {'a'}) );
+        CHECK( accepts(r, {'a', 'a'}) );
+        CHECK( accepts(r, {'b', 'c', 'a'}) );
+        CHECK( accepts(r, {'a', 'b', 'c', 'a'}) );
+        CHECK( !accepts(r, {'a', 'b', 'a'}) );
+        CHECK( !accepts(r, {'a', 'a', 'a', 'a'}) );
+
+        auto optional = Regexes::repeat(Regexes::opt(Regex::literal('a')), 2, 2);
+        CHECK( accepts(optional, {}) );
+        CHECK( accepts(optional, {'a'}) );
+        CHECK( accepts(optional, {'a', 'a'}) );
+        CHECK( !accepts(optional, {'a', 'a', 'a'}) );
+
+        auto at_least = Regexes::at_least(Regex::literal('a'), 2);
+        CHECK( !accepts(at_least, {'a'}) );
+        CHECK( accepts(at_least, {'a', 'a'}) );
+        CHECK( accepts(at_least, {'a', 'a', 'a', 'a', 'a'}) );
+
+        auto complemented = ~Regexes::repeat(Regex::literal('a'), 1, 2);
+        CHECK( accepts(complemented, {}) );
+        CHECK( !accepts(complemented, {'a'}) );
+        CHECK( !accepts(complemented, {'a', 'a'}) );
+        CHECK( accepts(complemented, {'a', 'a', 'a'}) );
+    }
 }
 
 TEMPLATE_TEST_CASE("Complex regexes accept/reject as expected", "[template][regex]", ACCEPTERS) {
@@ -547,4 +587,147 @@ TEMPLATE_TEST_CASE("Complex regexes accept/reject as expected", "[template][rege
         REQUIRE( !accepts(s2, {'a', 'c', 'b', 'd', 'a', 'c'}) );
         REQUIRE( accepts(s2, {'a', 'c', 'b', 'd', 'b', 'c', 'z'}) );
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Combinators over many regexes build balanced regexes", "[regex]") {
+    std::vector<char> letters;
+    for(int i = 0; i < 200; ++i) {
+        letters.push_back('a' + i % 26);
+    }
+
+    auto word = Regexes::word(letters);
+    CHECK( word.depth() == 9 );
+    CHECK( tfl::make_dfa(word).munch(letters) == letters.size() );
+
+    auto any = Regexes::any_of(letters);
+    CHECK( any.depth() == 9 );
+    CHECK( tfl::make_dfa(any).munch(std::string("z")) == 1 );
+    CHECK( Regexes::range('\x01', '\x7f').depth() == 8 );
+
+    std::vector<Regex> words;
+    for(int i = 0; i < 100; ++i) {
+        words.push_back(Regexes::word("kw" + std::to_string(i)));
+    }
+    auto keywords = Regexes::any_of(words);
+    CHECK( keywords.depth() == 7 + 3 );
+    auto dfa = tfl::make_dfa(keywords);
+    CHECK( dfa.munch(std::string("kw99")) == 4 );
+    CHECK( dfa.munch(std::string("kw100")) == 4 );
+}
+
+TEST_CASE("Glushkov automata have a state per position", "[regex]") {
+    Regex s = Regex::alphabet();
+
+    for(auto const& [regex, positions]: std::vector<std::pair<Regex, std::size_t>>{
+        {Regex::empty(), 0},
+        {Regex::epsilon(), 0},
+        {a - b - a, 3},
+        {*(a | b) - a - s, 3},
+        {Regexes::range('a', 'c') - *a, 2},
+        {*(*a - b) | Regexes::opt(c - a), 4},
+        {Regex::capture(0, +a) - *(s - c), 4},
+    }) {
+        INFO( to_string(regex) );
+        auto glushkov = tfl::make_glushkov_nfa(regex);
+        auto thompson = tfl::make_nfa(regex);
+        CHECK( glushkov.state_count() == positions + 1 );
+
+        for(std::vector<char> w: std::vector<std::vector<char>>{{}, {'a'}, {'a', 'b', 'a'}, {'b', 'a', 'a', 'z'}, {'a', 'a', 'c'}, {'c', 'a'}, {'a', 'z', 'c', 'y', 'c'}}) {
+            CHECK( glushkov.accepts(w) == thompson.accepts(w) );
+        }
+    }
+
+    CHECK_THROWS_AS( tfl::make_glushkov_nfa(~a), std::invalid_argument );
+    CHECK_THROWS_AS( tfl::make_glushkov_nfa(*a & *b), std::invalid_argument );
+}
+
+TEST_CASE("Partial derivatives split the derivatives", "[regex]") {
+    Regex s = Regex::alphabet();
+
+    CHECK( tfl::partial_derive('a', a | b).size() == 1 );
+    CHECK( tfl::partial_derive('a', (a - b) | (a - c) | (a - b)).size() == 2 );
+    CHECK( tfl::partial_derive('a', (a - b) | (b - c)) == std::vector<Regex>{b} );
+    CHECK( tfl::partial_derive('z', a - b).empty() );
+    CHECK( tfl::partial_derive('z', s - b) == std::vector<Regex>{b} );
+    CHECK( tfl::partial_derive('a', *(a - b)) == std::vector<Regex>{b - *(a - b)} );
+    CHECK( tfl::partial_derive('a', ~((a - b) | (a - c))) == std::vector<Regex>{~(b | c)} );
+}
+
+TEST_CASE("Partial-derivative automata are no larger than Glushkov automata", "[regex]") {
+    Regex s = Regex::alphabet();
+
+    for(auto const& regex: {
+        a - b - a,
+        *(a | b) - a - s,
+        (a - b - c) | (a - b - a) | (a - c),
+        *(*a - b) | Regexes::opt(c - a),
+        Regex::capture(0, +a) - *(s - c),
+    }) {
+        INFO( to_string(regex) );
+        CHECK( tfl::make_nfa_by_partial_derivatives(regex).state_count() <= tfl::make_glushkov_nfa(regex).state_count() );
+    }
+
+    CHECK( tfl::make_nfa_by_partial_derivatives((a - b - c) | (a - b - a)).state_count() == 6 );
+    CHECK( tfl::make_glushkov_nfa((a - b - c) | (a - b - a)).state_count() == 7 );
+}
+
+TEST_CASE("Bounded repetitions are not unrolled", "[regex]") {
+    CHECK_THROWS_AS( Regexes::repeat(a, 3, 2), std::invalid_argument );
+    CHECK( Regexes::repeat(a, 0, 0) == e );
+    CHECK( Regexes::repeat(a, 1) == a );
+    CHECK( Regexes::repeat(*a, 2, 5) == *a );
+    CHECK( Regexes::repeat(Regex::empty(), 0, 5) == e );
+    CHECK( Regexes::repeat(Regex::empty(), 1, 5) == Regex::empty() );
+    CHECK( to_string(Regexes::repeat(a, 2, 3) - b) == "{2,3}ab" );
+    CHECK( to_string(Regexes::repeat(a | b, 4)) == "{4}(a | b)" );
+
+    // The size of the regex and of its derivatives does not depend on the bounds.
+    Regex hex = Regexes::range('0', '9') | Regexes::range('a', 'f');
+    Regex many = Regexes::repeat(hex, 1, 1000);
+    CHECK( many.size() == hex.size() + 1 );
+    CHECK( tfl::derive('7', many) == Regexes::repeat(hex, 0, 999) );
+    CHECK( tfl::partial_derive('7', many) == std::vector<Regex>{Regexes::repeat(hex, 0, 999)} );
+
+    // The DFA needs a state per count, but no more.
+    Regex quoted = Regex::literal('"') - Regexes::repeat(hex, 1, 100) - Regex::literal('"');
+    auto dfa = tfl::make_dfa(quoted);
+    CHECK( dfa.state_count() <= 104 );
+    CHECK( dfa.accepts(std::string("\"0\"")) );
+    CHECK( dfa.accepts("\"" + std::string(100, 'f') + "\"") );
+    CHECK( !dfa.accepts("\"" + std::string(101, 'f') + "\"") );
+    CHECK( !dfa.accepts(std::string("\"\"")) );
+}
+
+TEST_CASE("Inclusion and equivalence of languages", "[regex]") {
+    Regex s = Regex::alphabet();
+    Regex digit = Regexes::range('0', '9');
+
+    CHECK( tfl::is_subset(a, a | b) );
+    CHECK( !tfl::is_subset(a | b, a) );
+    CHECK( tfl::is_subset(a - b, *(a | b)) );
+    CHECK( tfl::is_subset(Regex::empty(), a) );
+    CHECK( tfl::is_subset(e, *a) );
+    CHECK( !tfl::is_subset(*a, +a) );
+    CHECK( tfl::is_subset(+digit, *s) );
+    CHECK( !tfl::is_subset(s, digit) );
+    CHECK( tfl::is_subset(Regexes::word(std::string("while")), +Regexes::range('a', 'z')) );
+
+    CHECK( tfl::is_equivalent(a | b, b | a) );
+    CHECK( tfl::is_equivalent(*(a | b), *(*a - *b)) );
+    CHECK( tfl::is_equivalent(a - *a, +a) );
+    CHECK( tfl::is_equivalent(~Regex::empty(), *s) );
+    CHECK( tfl::is_equivalent(Regexes::repeat(a, 1, 3), a | (a - a) | (a - a - a)) );
+    CHECK( !tfl::is_equivalent(*a, +a) );
+    CHECK( !tfl::is_equivalent(a - b, b - a) );
+
+    // Values which belong to no alphabet are compared as well, unless there is none left.
+    CHECK( !tfl::is_subset(s, digit | a) );
+    CHECK( tfl::is_equivalent(Regexes::range(std::numeric_limits<char>::min(), std::numeric_limits<char>::max()), s) );
+
+    // The DFAs can be compared directly.
+    auto left = tfl::make_dfa(digit - *s);
+    auto right = tfl::make_dfa(*s - digit);
+    CHECK( !tfl::is_subset(left, right) );
+    CHECK( !tfl::is_subset(right, left) );
+    CHECK( tfl::is_subset(left, tfl::make_dfa(~(a - *s))) );
+}
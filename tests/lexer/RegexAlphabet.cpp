@@ -51,4 +51,30 @@ TEST_CASE("Regexes have expected minimal alphabet") {
         test(a | (b-f) | (c-(d | any)) , {'a', 'c'});
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("Shared subexpressions are only traversed once") {
+    // A tree of more than 2^40 nodes, but only 123 distinct ones.
+    Regex regex = Regex::literal('a') - Regex::literal('b');
+    for(int i = 0; i < 40; ++i) {
+        regex = regex | (regex - Regex::literal('c' + i % 3));
+    }
+    CHECK( generate_minimal_alphabet(regex) == std::set<char>{'a', 'b', 'c', 'd', 'e'} );
+
+    struct Counter final: tfl::matchers::MemoBase<char, int> {
+        int matched = 0;
+
+        int empty() { return ++matched; }
+        int epsilon() { return ++matched; }
+        int alphabet() { return ++matched; }
+        int literal(char const&) { return ++matched; }
+        int disjunction(Regex const& l, Regex const& r) { memo(l); memo(r); return ++matched; }
+        int sequence(Regex const& l, Regex const& r) { memo(l); memo(r); return ++matched; }
+        int kleene_star(Regex const& r) { memo(r); return ++matched; }
+        int complement(Regex const& r) { memo(r); return ++matched; }
+        int conjunction(Regex const& l, Regex const& r) { memo(l); memo(r); return ++matched; }
+    } counter;
+    counter.memo(regex);
+    // The first sequence and its literals, then a literal, a sequence and a disjunction per iteration.
+    CHECK( counter.matched == 3 + 3 * 40 );
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "tfl/Regex.hpp"
+
+using Regex = tfl::Regex<char>;
+using Regexes = tfl::Regexes<char>;
+
+auto has_empty_language = tfl::has_empty_language<char>;
+
+TEST_CASE("Regexes are structurally equal when built the same way") {
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+
+    CHECK( a == Regex::literal('a') );
+    CHECK( a != b );
+    CHECK( (a - *b) == (Regex::literal('a') - *Regex::literal('b')) );
+    CHECK( (a | b) != (b | a) );
+    CHECK( Regex::capture(0, a) != Regex::capture(1, a) );
+    CHECK( ~~a == a );
+}
+
+TEST_CASE("Base regexes have expected emptiness") {
+    CHECK(  has_empty_language(Regex::empty()) );
+    CHECK( !has_empty_language(Regex::epsilon()) );
+    CHECK( !has_empty_language(Regex::alphabet()) );
+    CHECK( !has_empty_language(Regex::literal('a')) );
+    CHECK( !has_empty_language(Regex::any()) );
+}
+
+TEST_CASE("Semantically empty regexes are detected") {
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+
+    CHECK( has_empty_language(a & ~a) );
+    CHECK( has_empty_language(~(a - *b) & (a - *b)) );
+    CHECK( has_empty_language(b - (a & ~a)) );
+    CHECK( has_empty_language((a & ~a) | ~(a | ~a)) );
+    CHECK( has_empty_language(a - ~*Regex::alphabet()) );
+    CHECK( has_empty_language(~(*a | ~*a)) );
+    CHECK( has_empty_language(Regex::capture(0, a & ~a)) );
+
+    // Their derivatives are too.
+    CHECK( has_empty_language(tfl::derive('a', a & ~a)) );
+    CHECK( has_empty_language(tfl::derive('b', a & ~a)) );
+}
+
+TEST_CASE("Nonempty regexes are never reported as empty") {
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+
+    for(auto const& regex: {
+        a & ~b, ~a, *(a & ~a), ~(a | b), (a - b) & ~(a - b - b), a - *~a, ~(a & ~a), Regex::capture(0, *a) - b,
+    }) {
+        INFO( tfl::to_string(regex) );
+        CHECK( !has_empty_language(regex) );
+    }
+}
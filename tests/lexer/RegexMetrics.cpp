@@ -79,4 +79,27 @@ TEST_CASE("Compacted regexes have expected size/depth") {
     test_dualton(any | a, "¬∅ | a");
     test_dualton(a | any2, "a | *Σ");
     test_dualton(any2 | a, "*Σ | a");
-}
\ No newline at end of file
+}
+
+TEST_CASE("Regexes summarize the values they may read") {
+    auto a = Regex::literal('a');
+    auto b = Regex::literal('b');
+    auto c = Regex::literal('c');
+
+    auto regex = *(a | b) - Regex::capture(0, c);
+    CHECK( regex.may_read('a') );
+    CHECK( regex.may_read('c') );
+    CHECK( regex.nullable() == tfl::is_nullable(regex) );
+
+    // Σ and complements may read any value.
+    CHECK( (a - Regex::alphabet()).may_read('z') );
+    CHECK( (~a).may_read('z') );
+    CHECK( !Regex::empty().may_read('a') );
+
+    // The derivative w.r.t. a value which cannot be read is empty.
+    for(char x = 'd'; x <= 'z'; ++x) {
+        if(!regex.may_read(x)) {
+            CHECK( tfl::is_empty(tfl::derive(x, regex)) );
+        }
+    }
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "tfl/Regex.hpp"
+#include "tfl/AutomataOps.hpp"
 
 using Regexes = tfl::Regexes<char>;
 
@@ -66,4 +67,31 @@ TEST_CASE("Regexes are printed as expected") {
         CHECK( to_string(*~a) == "*¬a" );
         CHECK( to_string(*~*a) == "*¬*a" );
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Deep regexes are traversed without overflowing the stack") {
+    auto deep = [](char first) {
+        auto regex = Regexes::literal(first);
+        for(int i = 0; i < 200000; ++i) {
+            regex = regex - Regexes::literal('a' + i % 3);
+        }
+        return regex;
+    };
+    auto regex = deep('a');
+    REQUIRE( regex.depth() == 200001 );
+
+    CHECK( to_string(regex).size() == 200001 );
+    CHECK( tfl::generate_minimal_alphabet(regex) == std::set<char>{'a', 'b', 'c'} );
+
+    // Separately built regexes share no node.
+    auto same = deep('a');
+    CHECK( regex == same );
+    CHECK_FALSE( regex == deep('b') );
+    CHECK( tfl::is_equivalent(regex, same) );
+
+    CHECK( tfl::derive('a', regex).depth() == 200000 );
+    CHECK( tfl::is_empty(tfl::derive('b', regex)) );
+    CHECK( tfl::partial_derive('a', regex).size() == 1 );
+    CHECK_FALSE( tfl::has_empty_language(regex) );
+    CHECK( tfl::has_empty_language(regex & ~same) );
+}
@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "tfl/Search.hpp"
+
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+using Regex = tfl::Regex<char>;
+using Regexes = tfl::Regexes<char>;
+using Words = std::set<std::vector<char>>;
+
+namespace {
+    std::vector<char> w(std::string const& s) {
+        return {s.begin(), s.end()};
+    }
+
+    // Reference implementation: munches from every position.
+    std::vector<tfl::Match> naive_find_all(tfl::DFA<char> const& dfa, std::string const& haystack) {
+        std::vector<tfl::Match> matches;
+        for(std::size_t position = 0; position <= haystack.size();) {
+            auto length = dfa.munch(haystack.substr(position));
+            if(length.has_value()) {
+                matches.push_back({position, *length});
+                position += std::max<std::size_t>(*length, 1);
+            }
+            else {
+                ++position;
+            }
+        }
+        return matches;
+    }
+}
+
+TEST_CASE("Literal prefixes are extracted from regexes", "[search]") {
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+    Regex c = Regex::literal('c');
+
+    CHECK( tfl::literal_prefixes(Regex::empty()).empty() );
+    CHECK( tfl::literal_prefixes(Regex::epsilon()) == Words{w("")} );
+    CHECK( tfl::literal_prefixes(*a) == Words{w("")} );
+    CHECK( tfl::literal_prefixes(Regexes::word(std::string("while"))) == Words{w("while")} );
+    CHECK( tfl::literal_prefixes((a|b) - c - *a) == Words{w("ac"), w("bc")} );
+    CHECK( tfl::literal_prefixes(a - *b - c) == Words{w("a")} );
+    CHECK( tfl::literal_prefixes((a - b) | (a - b - c)) == Words{w("ab")} );
+    CHECK( tfl::literal_prefixes((a - Regex::any()) & (Regex::any() - c)) == Words{w("a")} );
+    CHECK( tfl::literal_prefixes(Regexes::word(std::string("abcdefghijkl"))) == Words{w("abcdefgh")} );
+    CHECK( tfl::literal_prefixes(Regexes::range('a', 'z') - Regexes::range('a', 'z') - c).size() == 26 );
+    CHECK( tfl::literal_prefixes(Regexes::range('!', '~') - c) == Words{w("")} );
+}
+
+TEST_CASE("Searchers find leftmost-longest matches", "[search]") {
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+    Regex c = Regex::literal('c');
+    Regex digit = Regexes::range('0', '9');
+
+    SECTION("Keywords") {
+        tfl::Searcher<char> searcher(Regexes::any_of({
+            Regexes::word(std::string("if")),
+            Regexes::word(std::string("else")),
+            Regexes::word(std::string("elsif")),
+        }));
+        std::string haystack("x if elsif else eif");
+
+        CHECK( searcher.has_prefilter() );
+        CHECK( searcher.find_first(haystack) == tfl::Match{2, 2} );
+        CHECK( searcher.find_all(haystack) == std::vector<tfl::Match>{{2, 2}, {5, 5}, {11, 4}, {17, 2}} );
+        CHECK( searcher.find_all(std::string("nothing to see")).empty() );
+        CHECK( !searcher.find_first(std::string()).has_value() );
+    }
+
+    SECTION("Overlapping prefixes") {
+        tfl::Searcher<char> searcher((a - b - *c) | (b - *c - a));
+        std::string haystack("aabccbcca");
+
+        CHECK( searcher.prefixes() == Words{w("ab"), w("b")} );
+        CHECK( searcher.find_all(haystack) == std::vector<tfl::Match>{{1, 4}, {5, 4}} );
+    }
+
+    SECTION("Without prefilter") {
+        tfl::Searcher<char> searcher(*digit);
+        CHECK( !searcher.has_prefilter() );
+        CHECK( searcher.find_all(std::string("1a23")) == std::vector<tfl::Match>{{0, 1}, {1, 0}, {2, 2}, {4, 0}} );
+    }
+
+    SECTION("Non-contiguous inputs") {
+        tfl::Searcher<char> searcher(Regexes::word(std::string("ab")) - +digit);
+        std::string haystack("ab1 ab ab23a");
+        std::deque<char> deque(haystack.begin(), haystack.end());
+
+        CHECK( searcher.find_all(deque) == std::vector<tfl::Match>{{0, 3}, {7, 4}} );
+        CHECK( searcher.find_all(deque) == searcher.find_all(haystack) );
+    }
+
+    SECTION("Prebuilt DFAs") {
+        tfl::Searcher<char> searcher(tfl::make_dfa(a - +b), {w("ab")});
+        CHECK( searcher.find_first(std::string("ba abb")) == tfl::Match{3, 3} );
+    }
+}
+
+TEST_CASE("Searchers agree with munching at every position", "[search]") {
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+    Regex c = Regex::literal('c');
+    Regex d = Regex::literal('d');
+
+    std::vector<Regex> regexes{
+        Regex::empty(),
+        a,
+        a - b,
+        (a - b) | (b - c - d) | (c - *a),
+        (a | b) - *(c | d) - a,
+        Regexes::word(std::string("abcabcabcd")),
+        (Regexes::opt(a) - b - c) & (Regex::any() - c),
+        (a - ~(Regex::any() - d - Regex::any())) / (Regex::any() - b),
+        *(a - b) - c,
+    };
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> letter(0, 4);
+    std::vector<std::string> haystacks;
+    for(std::size_t length: {0, 1, 5, 17, 64, 300}) {
+        for(int i = 0; i < 8; ++i) {
+            std::string haystack;
+            for(std::size_t j = 0; j < length; ++j) {
+                haystack.push_back("abcdx"[letter(generator)]);
+            }
+            haystacks.push_back(haystack);
+        }
+    }
+
+    for(auto const& regex: regexes) {
+        INFO( tfl::to_string(regex) );
+        tfl::Searcher<char> searcher(regex);
+        auto dfa = tfl::make_dfa(regex);
+
+        for(auto const& haystack: haystacks) {
+            INFO( haystack );
+            auto expected = naive_find_all(dfa, haystack);
+            auto matches = searcher.find_all(haystack);
+            CHECK( matches == expected );
+
+            auto first = searcher.find_first(haystack);
+            REQUIRE( first.has_value() == !expected.empty() );
+            if(first.has_value()) {
+                CHECK( *first == expected.front() );
+            }
+        }
+    }
+}
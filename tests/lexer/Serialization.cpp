@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "tfl/Serialization.hpp"
+#include "tfl/Lexer.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Regex = tfl::Regex<char>;
+using Regexes = tfl::Regexes<char>;
+using DFA = tfl::DFA<char>;
+
+namespace {
+    std::vector<std::string> all_words(std::string const& alphabet, std::size_t max_length) {
+        std::vector<std::string> words{""};
+        for(std::size_t i = 0; i < words.size() && words[i].size() < max_length; ++i) {
+            for(char c: alphabet) {
+                words.push_back(words[i] + c);
+            }
+        }
+        return words;
+    }
+
+    std::filesystem::path temporary_directory(std::string const& name) {
+        auto dir = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        return dir;
+    }
+}
+
+TEST_CASE("DFAs can be serialized", "[automata][serialization]") {
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+    Regex c = Regex::literal('c');
+
+    std::vector<Regex> regexes{
+        Regex::empty(),
+        Regex::epsilon(),
+        Regex::any(),
+        *(a|b|c) / *(a-Regexes::opt(b|c)),
+        (a-*b) | ~(c-Regex::alphabet())
+    };
+
+    for(auto const& regex: regexes) {
+        INFO( tfl::to_string(regex) );
+        DFA dfa = tfl::make_dfa(regex);
+        std::stringstream stream;
+        tfl::serialize(dfa, stream);
+
+        std::string bytes = stream.str();
+        std::vector<std::uint64_t> aligned(bytes.size() / 8);
+        std::memcpy(aligned.data(), bytes.data(), bytes.size());
+        tfl::DFAView<char> view(std::as_bytes(std::span(aligned)));
+        DFA copy = tfl::deserialize<char>(stream);
+
+        CHECK( bytes.size() % 8 == 0 );
+        CHECK( copy.state_count() == dfa.state_count() );
+        CHECK( view.state_count() == dfa.state_count() );
+        for(auto const& word: all_words("abcz", 4)) {
+            INFO( word );
+            CHECK( copy.accepts(word) == dfa.accepts(word) );
+            CHECK( view.accepts(word) == dfa.accepts(word) );
+            CHECK( view.munch(word) == dfa.munch(word) );
+        }
+    }
+}
+
+TEST_CASE("Invalid serialized DFAs are rejected", "[automata][serialization]") {
+    std::stringstream stream;
+    tfl::serialize(tfl::make_dfa(Regex::literal('a')), stream);
+    std::string bytes = stream.str();
+
+    SECTION("Truncated") {
+        std::stringstream truncated(bytes.substr(0, bytes.size() - 8));
+        CHECK_THROWS_AS( tfl::deserialize<char>(truncated), tfl::SerializationException );
+    }
+
+    SECTION("Magic number") {
+        bytes[0] = 'X';
+        std::stringstream invalid(bytes);
+        CHECK_THROWS_AS( tfl::deserialize<char>(invalid), tfl::SerializationException );
+    }
+
+    SECTION("Literal type") {
+        std::stringstream other(bytes);
+        CHECK_THROWS_AS( tfl::deserialize<int>(other), tfl::SerializationException );
+    }
+
+    SECTION("State count") {
+        std::uint64_t states = std::uint64_t(1) << 62;
+        std::memcpy(bytes.data() + 16, &states, sizeof(states));
+        std::stringstream invalid(bytes);
+        CHECK_THROWS_AS( tfl::deserialize<char>(invalid), tfl::SerializationException );
+    }
+
+    SECTION("Transition target") {
+        // The first transition follows the header (32 bytes) and the symbol, padded to 8 bytes.
+        std::uint64_t target = 1000;
+        std::memcpy(bytes.data() + 40, &target, sizeof(target));
+        std::stringstream invalid(bytes);
+        CHECK_THROWS_AS( tfl::deserialize<char>(invalid), tfl::SerializationException );
+    }
+}
+
+TEST_CASE("Serialized DFAs can be memory-mapped", "[automata][serialization]") {
+    auto dir = temporary_directory("tfl-serialization-tests");
+    Regex digit = Regexes::range('0', '9');
+    Regex alpha = Regexes::range('a', 'z');
+
+    {
+        std::ofstream out(dir / "tables.tfls", std::ios::binary);
+        tfl::serialize({
+            tfl::make_dfa(Regex::literal('\n')),
+            tfl::make_dfa(+digit),
+            tfl::make_dfa(+alpha),
+            tfl::make_dfa(+(Regex::literal(' ') | Regex::literal('\n'))),
+        }, out);
+    }
+
+    auto tables = tfl::map_dfa_set<char>(dir / "tables.tfls");
+    REQUIRE( tables.size() == 4 );
+    CHECK( tables[1].munch(std::string("123ab")) == 3 );
+    CHECK( tables[2].munch(std::string("ab123")) == 2 );
+    CHECK_THROWS( tables[4] );
+
+    using Rule = tfl::Rule<char, tfl::DFAView<char>, std::string>;
+    auto lexer = tfl::Lexer<char, std::string>::make_dfa_lexer({
+        Rule{tables[1], [](auto){ return std::string("number"); }},
+        Rule{tables[2], [](auto){ return std::string("word"); }},
+        Rule{tables[3], [](auto){ return std::string("space"); }},
+    }, tables[0]);
+
+    auto result = lexer(std::string("ab 12"));
+    REQUIRE( result.size() == 3 );
+    CHECK( result[0].value() == "word" );
+    CHECK( result[2].value() == "number" );
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("DFAs can be cached", "[automata][serialization]") {
+    auto dir = temporary_directory("tfl-cache-tests");
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+
+    {
+        tfl::DFACache<char> cache(dir);
+        DFA dfa = tfl::make_dfa(*a - b, cache);
+        tfl::make_dfa(*a - b, cache);
+        tfl::make_dfa(*b - a, cache);
+
+        CHECK( cache.size() == 2 );
+        CHECK( dfa.accepts(std::string("aab")) );
+        CHECK( std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator()) == 2 );
+    }
+
+    {
+        tfl::DFACache<char> cache(dir);
+        DFA dfa = tfl::make_dfa(*b - a, cache);
+        CHECK( dfa.accepts(std::string("bba")) );
+        CHECK( !dfa.accepts(std::string("aab")) );
+
+        auto lexer = tfl::Lexer<char, char>::make_dfa_lexer({
+            {*a - b, [](auto){ return 'x'; }},
+            {*b - a, [](auto){ return 'y'; }},
+        }, Regex::empty(), cache);
+
+        auto result = lexer(std::string("aabba"));
+        REQUIRE( result.size() == 2 );
+        CHECK( result[0].value() == 'x' );
+        CHECK( result[1].value() == 'y' );
+        CHECK( cache.size() == 3 );
+    }
+
+    std::filesystem::remove_all(dir);
+}
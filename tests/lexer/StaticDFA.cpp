@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "tfl/StaticDFA.hpp"
+#include "tfl/Lexer.hpp"
+
+#include <string_view>
+#include <variant>
+
+using Regex = tfl::Regex<char>;
+using Regexes = tfl::Regexes<char>;
+using StaticRegexes = tfl::StaticRegexes<char>;
+
+using namespace std::string_view_literals;
+
+static constexpr auto number = tfl::make_static_dfa<[]{
+    using R = StaticRegexes;
+    auto digit19 = R::range('1', '9');
+    auto digit = R::range('0', '9');
+
+    auto base = R::opt(R::literal('-')) - (R::literal('0') | (digit19 - *digit));
+    auto fraction = R::literal('.') - +digit;
+    auto exponent = R::any_of("eE"sv) - R::opt(R::any_of("+-"sv)) - +digit;
+
+    return base - R::opt(fraction) - R::opt(exponent);
+}>();
+
+static constexpr auto string = tfl::make_static_dfa<[]{
+    using R = StaticRegexes;
+    auto quote = R::literal('"');
+    auto str_char = R::alphabet() / (R::literal('\\') | quote);
+    auto control = R::literal('\\') - R::any_of("\"\\/bfnrt"sv);
+
+    return quote - *(str_char | control) - quote;
+}>();
+
+TEST_CASE("Static DFAs are built at compile time", "[automata][static]") {
+    STATIC_REQUIRE( number.accepts("0"sv) );
+    STATIC_REQUIRE( number.accepts("-12.5e+3"sv) );
+    STATIC_REQUIRE( !number.accepts("012"sv) );
+    STATIC_REQUIRE( !number.accepts("1."sv) );
+    STATIC_REQUIRE( number.munch("12.5x"sv) == 4 );
+    STATIC_REQUIRE( number.munch("1.x"sv) == 1 );
+    STATIC_REQUIRE( !number.munch("x"sv).has_value() );
+
+    STATIC_REQUIRE( string.accepts("\"\""sv) );
+    STATIC_REQUIRE( string.accepts("\"a\\\"b\""sv) );
+    STATIC_REQUIRE( !string.accepts("\"a\\\""sv) );
+    STATIC_REQUIRE( string.munch("\"ab\" \"c\""sv) == 4 );
+
+    STATIC_REQUIRE( number.view().munch("12.5x"sv) == 4 );
+    STATIC_REQUIRE( !tfl::StaticDFAView<char>().munch(""sv).has_value() );
+}
+
+TEST_CASE("Static DFAs accept the same language as DFAs", "[automata][static]") {
+    static constexpr auto s1 = tfl::make_static_dfa<[]{
+        using R = StaticRegexes;
+        auto a = R::literal('a'), b = R::literal('b'), c = R::literal('c');
+        return *(a|b|c) / *(a - R::opt(b|c));
+    }>();
+
+    static constexpr auto s2 = tfl::make_static_dfa<[]{
+        using R = StaticRegexes;
+        auto a = R::literal('a'), b = R::literal('b'), c = R::literal('c'), d = R::literal('d');
+        return *((a|b) - (c|d) - R::opt(R::alphabet())) / (R::any() - d - a - R::any());
+    }>();
+
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+    Regex c = Regex::literal('c');
+    Regex d = Regex::literal('d');
+    Regex any = Regex::any();
+
+    auto d1 = tfl::make_dfa(*(a|b|c) / *(a-Regexes::opt(b|c)));
+    auto d2 = tfl::make_dfa(*((a|b) - (c|d) - Regexes::opt(Regex::alphabet())) / (any-d-a-any));
+
+    std::vector<std::vector<char>> inputs{{}};
+    for(std::size_t i = 0; i < inputs.size() && inputs[i].size() < 5; ++i) {
+        for(char x: {'a', 'b', 'c', 'd', 'z'}) {
+            inputs.push_back(inputs[i]);
+            inputs.back().push_back(x);
+        }
+    }
+
+    for(auto const& input: inputs) {
+        INFO( std::string(input.begin(), input.end()) );
+        CHECK( s1.accepts(input) == d1.accepts(input) );
+        CHECK( s1.munch(input) == d1.munch(input) );
+        CHECK( s2.accepts(input) == d2.accepts(input) );
+        CHECK( s2.munch(input) == d2.munch(input) );
+        CHECK( s2.to_dfa().accepts(input) == d2.accepts(input) );
+    }
+}
+
+TEST_CASE("Static DFAs can be used by lexers", "[automata][static]") {
+    using R = std::variant<double, std::string>;
+    using Rule = tfl::Rule<char, tfl::StaticDFAView<char>, R>;
+
+    static constexpr auto space = tfl::make_static_dfa<[]{ return +StaticRegexes::literal(' '); }>();
+
+    auto lexer = tfl::Lexer<char, R>::make_dfa_lexer({
+        Rule{number, [](auto w){ return std::stod(std::string(w.begin(), w.end())); }},
+        Rule{string, [](auto w){ return std::string(w.begin(), w.end()); }},
+        Rule{space, [](auto){ return std::string(); }},
+    });
+
+    std::string input("12 \"a\" -1.5");
+    auto result = lexer(input);
+
+    REQUIRE( result.size() == 5 );
+    CHECK( result[0].value() == R(12.0) );
+    CHECK( result[2].value() == R(std::string("\"a\"")) );
+    CHECK( result[4].value() == R(-1.5) );
+    CHECK( result[4].column() == 8 );
+
+    static constexpr auto newline = tfl::make_static_dfa<[]{ return StaticRegexes::literal('\n'); }>();
+    auto lines = tfl::Lexer<char, R>::make_dfa_lexer({
+        Rule{number, [](auto w){ return std::stod(std::string(w.begin(), w.end())); }},
+        Rule{newline, [](auto){ return std::string(); }},
+    }, newline);
+
+    std::string multiline("1\n2\n3");
+    result = lines(multiline);
+
+    REQUIRE( result.size() == 5 );
+    CHECK( result[4].value() == R(3.0) );
+    CHECK( result[4].line() == 3 );
+}
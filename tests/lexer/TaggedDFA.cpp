@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "tfl/TaggedDFA.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using Regex = tfl::Regex<char>;
+using Regexes = tfl::Regexes<char>;
+using Groups = std::vector<std::optional<tfl::Match>>;
+
+TEST_CASE("Tagged DFAs recognize the same language as DFAs", "[tdfa]") {
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+    Regex c = Regex::literal('c');
+
+    for(auto const& regex: {
+        Regex::capture(0, *a) - Regex::capture(1, b | c),
+        *Regex::capture(0, a | (b - c)),
+        Regex::capture(0, ~(a - b)) - c,
+        Regex::capture(1, Regex::epsilon()) - a,
+        Regex::capture(0, Regex::empty()),
+    }) {
+        INFO( tfl::to_string(regex) );
+        auto tdfa = tfl::make_tagged_dfa(regex);
+        auto dfa = tfl::make_dfa(regex);
+
+        for(std::string s: {"", "a", "ab", "abc", "aab", "bcbc", "ac", "cab", "aaaac", "bcbca"}) {
+            INFO( s );
+            CHECK( tdfa.munch(s) == dfa.munch(s) );
+            auto submatches = tdfa.munch_submatches(s);
+            REQUIRE( submatches.has_value() == dfa.munch(s).has_value() );
+            if(submatches.has_value()) {
+                CHECK( submatches->length == *dfa.munch(s) );
+                CHECK( submatches->groups.size() == tdfa.group_count() );
+            }
+        }
+    }
+}
+
+TEST_CASE("Tagged DFAs report submatches", "[tdfa]") {
+    Regex a = Regex::literal('a');
+    Regex b = Regex::literal('b');
+    Regex digit = Regexes::range('0', '9');
+
+    SECTION("Sequences") {
+        auto tdfa = tfl::make_tagged_dfa(Regex::capture(0, +digit) - Regex::literal('.') - Regex::capture(1, *digit));
+        CHECK( tdfa.group_count() == 2 );
+        CHECK( tdfa.munch_submatches(std::string("12.345x")) == tfl::Submatches{6, {tfl::Match{0, 2}, tfl::Match{3, 3}}} );
+        CHECK( tdfa.munch_submatches(std::string("7.")) == tfl::Submatches{2, {tfl::Match{0, 1}, tfl::Match{2, 0}}} );
+        CHECK( !tdfa.munch_submatches(std::string(".5")).has_value() );
+    }
+
+    SECTION("Greediness") {
+        auto tdfa = tfl::make_tagged_dfa(Regex::capture(0, *a) - Regex::capture(1, *a));
+        CHECK( tdfa.munch_submatches(std::string("aaa")) == tfl::Submatches{3, {tfl::Match{0, 3}, tfl::Match{3, 0}}} );
+
+        auto lazy = tfl::make_tagged_dfa(Regex::capture(0, Regexes::opt(a)) - Regex::capture(1, a - *b));
+        CHECK( lazy.munch_submatches(std::string("abb")) == tfl::Submatches{3, {tfl::Match{0, 0}, tfl::Match{0, 3}}} );
+        CHECK( lazy.munch_submatches(std::string("aab")) == tfl::Submatches{3, {tfl::Match{0, 1}, tfl::Match{1, 2}}} );
+    }
+
+    SECTION("Alternatives") {
+        auto tdfa = tfl::make_tagged_dfa(Regex::capture(0, a - b) | Regex::capture(1, a - *b));
+        CHECK( tdfa.munch_submatches(std::string("ab")) == tfl::Submatches{2, {tfl::Match{0, 2}, std::nullopt}} );
+        CHECK( tdfa.munch_submatches(std::string("abb")) == tfl::Submatches{3, {std::nullopt, tfl::Match{0, 3}}} );
+        CHECK( tdfa.munch_submatches(std::string("a")) == tfl::Submatches{1, {std::nullopt, tfl::Match{0, 1}}} );
+    }
+
+    SECTION("Repetitions capture the last iteration") {
+        auto tdfa = tfl::make_tagged_dfa(*Regex::capture(0, a | (b - b)) - Regex::literal(';'));
+        CHECK( tdfa.munch_submatches(std::string("abba;")) == tfl::Submatches{5, {tfl::Match{3, 1}}} );
+        CHECK( tdfa.munch_submatches(std::string("abb;")) == tfl::Submatches{4, {tfl::Match{1, 2}}} );
+        CHECK( tdfa.munch_submatches(std::string(";")) == tfl::Submatches{1, {std::nullopt}} );
+    }
+
+    SECTION("Nested groups") {
+        auto tdfa = tfl::make_tagged_dfa(Regex::capture(0, a - Regex::capture(1, *b) - a));
+        CHECK( tdfa.munch_submatches(std::string("abbab")) == tfl::Submatches{4, {tfl::Match{0, 4}, tfl::Match{1, 2}}} );
+    }
+
+    SECTION("Input streams") {
+        auto tdfa = tfl::make_tagged_dfa(Regex::literal('"') - Regex::capture(0, *(Regex::alphabet() & ~Regex::literal('"'))) - Regex::literal('"'));
+        std::istringstream stream("\"hello\" world\"");
+        CHECK( tdfa.munch_submatches(std::views::istream<char>(stream)) == tfl::Submatches{7, {tfl::Match{1, 5}}} );
+    }
+}
+
+TEST_CASE("Captures are not supported within complements and conjunctions", "[tdfa]") {
+    Regex a = Regex::literal('a');
+    CHECK_THROWS_AS( tfl::make_tagged_dfa(~Regex::capture(0, a)), std::invalid_argument );
+    CHECK_THROWS_AS( tfl::make_tagged_dfa(Regex::capture(0, a) & *a), std::invalid_argument );
+    CHECK_NOTHROW( tfl::make_tagged_dfa(Regex::capture(0, ~a & *a)) );
+}
+
+TEST_CASE("Captures are printed with their group", "[tdfa]") {
+    Regex a = Regex::literal('a');
+    CHECK( tfl::to_string(Regex::capture(2, *a) - a) == "<2:*a>a" );
+}
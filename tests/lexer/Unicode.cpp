@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "tfl/Lexer.hpp"
+#include "tfl/Unicode.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using Regex = tfl::Regex<char32_t>;
+using Regexes = tfl::Regexes<char32_t>;
+
+static std::string utf8(std::u32string const& code_points) {
+    std::string bytes;
+    for(char32_t c: code_points) {
+        if(c < 0x80) {
+            bytes += static_cast<char>(c);
+        }
+        else if(c < 0x800) {
+            bytes += static_cast<char>(0xC0 | (c >> 6));
+            bytes += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else if(c < 0x10000) {
+            bytes += static_cast<char>(0xE0 | (c >> 12));
+            bytes += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            bytes += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else {
+            bytes += static_cast<char>(0xF0 | (c >> 18));
+            bytes += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            bytes += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            bytes += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    return bytes;
+}
+
+TEST_CASE("Code point ranges are compiled into UTF-8 byte ranges", "[unicode]") {
+    auto in_class = [](char32_t c) {
+        return (c >= 'a' && c <= 'z') || (c >= 0xE9 && c <= 0x3FF) || (c >= 0x7FA && c <= 0x1001) 
+            || (c >= 0x4E00 && c <= 0x9FFF) || (c >= 0xFFF0 && c <= 0x10402);
+    };
+    Regex regex = Regexes::range('a', 'z') | Regexes::range(0xE9, 0x3FF) | Regexes::range(0x7FA, 0x1001) 
+        | Regexes::range(0x4E00, 0x9FFF) | Regexes::range(0xFFF0, 0x10402);
+    auto dfa = tfl::make_utf8_dfa(regex);
+
+    // The bounds of the ranges, and of the code points encoded with the same bytes but the last ones.
+    std::vector<char32_t> code_points{0, 0x7F, 0x80, 0x7FF, 0x800, 0xFFFF, 0x10000, 0x10FFFF, 0xD7FF, 0xE000};
+    for(char32_t bound: {0x61, 0x7A, 0xE9, 0x3FF, 0x7FA, 0x1001, 0x4E00, 0x9FFF, 0xFFF0, 0x10402}) {
+        for(char32_t c: std::vector<char32_t>{bound - 1, bound, bound + 1, bound ^ 0x3F, bound ^ 0xFC0}) {
+            code_points.push_back(c);
+        }
+    }
+    for(char32_t c: code_points) {
+        if(c >= 0xD800 && c <= 0xDFFF) {
+            continue;
+        }
+        INFO( std::to_string(c) );
+        CHECK( dfa.accepts(utf8({c})) == in_class(c) );
+        CHECK( !dfa.accepts(utf8({c, c})) );
+    }
+}
+
+TEST_CASE("Unicode regexes are compiled into small byte-level DFAs", "[unicode]") {
+    CHECK( tfl::make_utf8_dfa(Regexes::range(0x4E00, 0x9FFF)).state_count() <= 5 );
+    CHECK( tfl::make_utf8_dfa(*Regex::alphabet()).state_count() <= 8 );
+
+    // A code point is a sequence of its bytes.
+    tfl::Regex<char> euro = tfl::to_utf8(Regex::literal(0x20AC));
+    CHECK( euro.size() == 5 );
+    CHECK( tfl::make_dfa(euro).accepts(std::string("\xE2\x82\xAC")) );
+}
+
+TEST_CASE("Complements only accept valid UTF-8", "[unicode]") {
+    Regex quote = Regex::literal('"');
+    auto string = tfl::make_utf8_dfa(quote - *(Regex::alphabet() & ~quote) - quote);
+
+    CHECK( string.accepts(utf8(U"\"héllo 世界 \U0001F600\"")) );
+    CHECK( string.accepts(utf8(U"\"\"")) );
+    CHECK( !string.accepts(utf8(U"\"\"\"")) );
+    CHECK( !string.accepts(std::string("\"\xC3\"")) );
+    CHECK( !string.accepts(std::string("\"\xC0\x80\"")) );
+    CHECK( !string.accepts(std::string("\"\xED\xA0\x80\"")) );
+    CHECK( !string.accepts(std::string("\"\xF4\x90\x80\x80\"")) );
+
+    auto not_a = tfl::make_utf8_dfa(~Regex::literal('a'));
+    CHECK( not_a.accepts(std::string()) );
+    CHECK( !not_a.accepts(std::string("a")) );
+    CHECK( not_a.accepts(utf8(U"éa")) );
+    CHECK( !not_a.accepts(std::string("\xC3")) );
+}
+
+TEST_CASE("Literals must be Unicode scalar values", "[unicode]") {
+    CHECK_THROWS_AS( tfl::to_utf8(Regex::literal(0xD800)), std::invalid_argument );
+    CHECK_THROWS_AS( tfl::to_utf8(Regex::literal(0x110000)), std::invalid_argument );
+    CHECK_NOTHROW( tfl::to_utf8(Regex::literal(0x10FFFF)) );
+}
+
+TEST_CASE("Lexers run on UTF-8 bytes with Unicode rules", "[unicode]") {
+    Regex letter = Regexes::range('a', 'z') | Regexes::range(0xE0, 0xFF) | Regexes::range(0x4E00, 0x9FFF);
+    auto lexer = tfl::Lexer<char, std::string>::make_dfa_lexer({
+        {tfl::make_utf8_dfa(+letter), [](auto match){ return std::string(match.begin(), match.end()); }},
+        {tfl::make_utf8_dfa(+Regex::literal(' ')), [](auto){ return std::string(); }},
+    });
+
+    std::string input = utf8(U"café 世界 x");
+    std::vector<std::string> words;
+    for(auto const& token: lexer(input)) {
+        words.push_back(token.value());
+    }
+    CHECK( words == std::vector<std::string>{utf8(U"café"), "", utf8(U"世界"), "", "x"} );
+}
+
+TEST_CASE("UTF-8 DFAs agree with DFAs over code points", "[unicode]") {
+    Regex regex = +(Regexes::range(0xE0, 0xFF) | Regexes::range(0x3B1, 0x3C9)) - Regex::literal(0x20AC);
+    auto bytes = tfl::make_utf8_dfa(regex);
+    auto code_points = tfl::make_dfa(regex);
+
+    for(std::u32string word: {U"àλ€", U"€", U"ÿÿα€", U"àλ", U"àλ€€", U"ß€"}) {
+        CHECK( bytes.accepts(utf8(word)) == code_points.accepts(word) );
+    }
+    CHECK( tfl::Stringify<char32_t>::convert(0x20AC) == "U+20AC" );
+}
@@ -3,6 +3,8 @@
 #include "tfl/Parser.hpp"
 
 #include <functional>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
 
 template<typename R>
@@ -136,4 +138,58 @@ TEST_CASE("Cross-recursion") {
     CHECK( p({'a'}) == 1 );
     CHECK( p({'b'}) == 2 );
     CHECK( p({'a', 'a', 'a', 'b', 'b', 'a'}) == 8 );
-}
\ No newline at end of file
+}
+
+TEST_CASE("Incremental parsing") {
+    using Parsers = tfl::Parsers<char>;
+
+    std::size_t mapped = 0;
+    auto digit = Parsers::elem([](char c){ return '0' <= c && c <= '9'; })
+        .map([&mapped](char c){ ++mapped; return c - '0'; });
+
+    Recursive<int> expr;
+    Parser<int> term = digit | (Parser<char>::elem('(') & expr & Parser<char>::elem(')'))
+        .map([](auto p){ return p.first.second; });
+    expr = (term & Parsers::many((Parser<char>::elem('+') & term).map([](auto p){ return p.second; })))
+        .map([](auto p){ int sum = p.first; for(int i: p.second) { sum += i; } return sum; });
+
+    Parser<int> p = expr;
+    tfl::IncrementalParser<char, int> incremental(p);
+
+    std::string input("1+(2+3)+4+(5+(6+7))+8+9");
+    CHECK( incremental.parse(input) == 45 );
+    CHECK( mapped == 9 );
+    CHECK( incremental.memo_size() > 0 );
+
+    SECTION("Unaffected results are reused") {
+        mapped = 0;
+        input.replace(14, 1, "(1+1)");
+        CHECK( input == "1+(2+3)+4+(5+((1+1)+7))+8+9" );
+        CHECK( incremental.reparse(tfl::Edit{14, 1, 5}, input) == 41 );
+        CHECK( mapped == 2 );
+        CHECK( p(input.begin(), input.end()) == 41 );
+    }
+
+    SECTION("Random edits") {
+        std::string const digits("0123456789");
+        for(std::size_t i = 0; i < 100; ++i) {
+            std::size_t position = (i * 7) % input.size();
+            if(digits.find(input[position]) == std::string::npos) {
+                continue;
+            }
+
+            std::string inserted = (i % 5 == 0) ? "(" + std::to_string(i % 10) + "+1)" : std::to_string(i % 10);
+            input.replace(position, 1, inserted);
+            INFO( input );
+            CHECK( incremental.reparse(tfl::Edit{position, 1, inserted.size()}, input) == p(input.begin(), input.end()) );
+        }
+    }
+
+    SECTION("Invalid inputs") {
+        input.insert(1, "+");
+        CHECK_THROWS_AS( incremental.reparse(tfl::Edit{1, 0, 1}, input), tfl::ParsingException );
+        input.erase(1, 1);
+        CHECK( incremental.reparse(tfl::Edit{1, 1, 0}, input) == 45 );
+        CHECK_THROWS_AS( incremental.reparse(tfl::Edit{0, 2, 0}, input), std::invalid_argument );
+    }
+}
@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "tfl/StaticParser.hpp"
+
+#include <functional>
+#include <type_traits>
+
+template<typename R>
+using Parser = tfl::Parser<char, R>;
+
+template<typename R>
+using Recursive = tfl::Recursive<char, R>;
+
+using StaticParsers = tfl::StaticParsers<char>;
+
+TEST_CASE("Static parser input tests") {
+
+    SECTION("Elem") {
+        auto p = StaticParsers::elem('a');
+
+        CHECK_THROWS( p({}) );
+        CHECK( p({'a'}) == 'a' );
+        CHECK_THROWS( p({'b'}) );
+        CHECK_THROWS( p({'a', 'a'}) );
+        CHECK_THROWS( p({'a', 'b'}) );
+    }
+
+    SECTION("Epsilon") {
+        auto p = StaticParsers::eps('a');
+
+        CHECK( p({}) == 'a' );
+        CHECK_THROWS( p({'a'}) );
+        CHECK_THROWS( p({'b'}) );
+        CHECK_THROWS( p({'a', 'a'}) );
+        CHECK_THROWS( p({'a', 'b'}) );
+    }
+
+    SECTION("Disjunction") {
+        auto p = StaticParsers::elem('a') | StaticParsers::eps('b');
+
+        CHECK( p({}) == 'b' );
+        CHECK( p({'a'}) == 'a' );
+        CHECK_THROWS( p({'b'}) );
+        CHECK_THROWS( p({'a', 'a'}) );
+        CHECK_THROWS( p({'a', 'b'}) );
+    }
+
+    SECTION("Sequence") {
+        using R = std::pair<char, int>;
+        auto p = StaticParsers::elem('a') & StaticParsers::eps(1);
+
+        STATIC_REQUIRE( std::is_same_v<decltype(p)::ValueType, R> );
+
+        CHECK_THROWS( p({}) );
+        CHECK( p({'a'}) == R{'a', 1} );
+        CHECK_THROWS( p({'b'}) );
+        CHECK_THROWS( p({'a', 'a'}) );
+        CHECK_THROWS( p({'a', 'b'}) );
+    }
+
+    SECTION("Map") {
+        auto p = StaticParsers::any().map([](char i)->int{ return i*i; });
+
+        STATIC_REQUIRE( std::is_same_v<decltype(p)::ValueType, int> );
+
+        CHECK_THROWS( p({}) );
+        CHECK( p({3}) == 9 );
+        CHECK( p({8}) == 64 );
+        CHECK_THROWS( p({1, 1}) );
+    }
+
+    SECTION("Ambiguity") {
+        auto p = StaticParsers::elem('a') | StaticParsers::any();
+
+        CHECK( p.parse_all({'a'}) == std::vector<char>{'a', 'a'} );
+        CHECK( p.parse_all({'b'}) == std::vector<char>{'b'} );
+        CHECK_THROWS( p({'a'}) );
+    }
+}
+
+TEST_CASE("Static parsers interoperate with type-erased parsers") {
+
+    SECTION("Static parsers convert to parsers") {
+        Parser<int> p = (StaticParsers::elem('a') & StaticParsers::elem('b'))
+            .map([](auto p){ return p.first + p.second; });
+
+        CHECK( p({'a', 'b'}) == 'a' + 'b' );
+        CHECK_THROWS( p({'a'}) );
+    }
+
+    SECTION("Parsers can be embedded") {
+        Parser<char> pa = Parser<char>::elem('a');
+        auto p1 = StaticParsers::elem('b') | pa;
+        auto p2 = pa | StaticParsers::elem('b');
+        auto p3 = (pa & StaticParsers::elem('b')).map([](auto p){ return p.second; });
+        auto p4 = (StaticParsers::elem('b') & pa).map([](auto p){ return p.second; });
+
+        STATIC_REQUIRE( tfl::static_parser<decltype(p1)> );
+        STATIC_REQUIRE( tfl::static_parser<decltype(p2)> );
+        STATIC_REQUIRE( tfl::static_parser<decltype(p3)> );
+        STATIC_REQUIRE( tfl::static_parser<decltype(p4)> );
+
+        CHECK( p1({'a'}) == 'a' );
+        CHECK( p1({'b'}) == 'b' );
+        CHECK( p2({'a'}) == 'a' );
+        CHECK( p2({'b'}) == 'b' );
+        CHECK( p3({'a', 'b'}) == 'b' );
+        CHECK( p4({'b', 'a'}) == 'a' );
+        CHECK_THROWS( p3({'b', 'a'}) );
+    }
+
+    SECTION("Recursion") {
+        Recursive<int> rec;
+        Parser<int> p = rec =
+            StaticParsers::eps(0) |
+            (StaticParsers::any() & rec)
+                .map([](std::pair<char, int> pair)->int{ return pair.first + pair.second; });
+
+        CHECK( p({}) == 0 );
+        CHECK( p({1}) == 1 );
+        CHECK( p({1, 10}) == 11 );
+        CHECK( p({1, 10, 100}) == 111 );
+    }
+
+    SECTION("Lifted recursion") {
+        Recursive<int> rec;
+        auto tail = StaticParsers::lift(rec);
+        auto p = (StaticParsers::elem('a') & tail).map([](auto p){ return p.second + 1; });
+        rec = StaticParsers::eps(0) | p;
+
+        CHECK( p({'a'}) == 1 );
+        CHECK( p({'a', 'a', 'a'}) == 3 );
+        CHECK_THROWS( p({}) );
+        CHECK_THROWS( p({'a', 'b'}) );
+    }
+}